@@ -0,0 +1,122 @@
+/**
+ * @file Fuzz_BLE_Framer.c
+ * @brief Fuzzing harness for the BLE packet framing in BLE_UART_InString().
+ *
+ * The first input byte selects the buffer size passed to BLE_UART_InString() (1 to
+ * BLE_UART_BUFFER_SIZE) and the remaining bytes are received by the simulated EUSCI_A3,
+ * followed by two copies of a valid packet. The harness reads frames until every byte has been
+ * received and aborts if:
+ *
+ *  - a frame is longer than the buffer, or a full-size frame does not start with `!G`
+ *    (out-of-bounds writes are caught by the address sanitizer on the heap buffer), or
+ *
+ *  - the last frame is not the valid packet, i.e. the receiver failed to resynchronize after the
+ *    fuzzed bytes.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "inc/BLE_UART.h"
+
+// Largest fuzzed stream that fits in the receive FIFO together with the two trailing packets
+#define FUZZ_BLE_FRAMER_MAX_INPUT (HAL_HOST_FIFO_SIZE - 2 * BLE_UART_PACKET_SIZE)
+
+// Valid packet with all three values set to 0, which contains no other `!` than its prefix
+static const uint8_t Fuzz_Resync_Packet[BLE_UART_PACKET_SIZE] = {
+    0x21, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97
+};
+
+static uint8_t Fuzz_Stream[FUZZ_BLE_FRAMER_MAX_INPUT + 2 * BLE_UART_PACKET_SIZE];
+static uint32_t Fuzz_Stream_Length;
+static uint32_t Fuzz_Stream_Offset;
+
+static jmp_buf Fuzz_End;
+
+/**
+ * @brief Feeds the stream into the EUSCI_A3 receive FIFO and ends the run once it has been read.
+ */
+static void Fuzz_Poll_Hook(void) {
+    Fuzz_Stream_Offset += HAL_Host_EUSCI_Feed(EUSCI_A3, &Fuzz_Stream[Fuzz_Stream_Offset], Fuzz_Stream_Length - Fuzz_Stream_Offset);
+
+    if ((Fuzz_Stream_Offset == Fuzz_Stream_Length) && (HAL_Host_EUSCI_Pending(EUSCI_A3) == 0) && !(EUSCI_A3->IFG & 0x01)) {
+        longjmp(Fuzz_End, 1);
+    }
+}
+
+/**
+ * @brief Aborts if the receiver waits without consuming the remaining bytes.
+ */
+static void Fuzz_Stalled(void) {
+    abort();
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 1) {
+        return 0;
+    }
+
+    uint16_t buffer_size = 1 + (data[0] % BLE_UART_BUFFER_SIZE);
+
+    data++;
+    size--;
+
+    if (size > FUZZ_BLE_FRAMER_MAX_INPUT) {
+        size = FUZZ_BLE_FRAMER_MAX_INPUT;
+    }
+
+    memcpy(Fuzz_Stream, data, size);
+    memcpy(&Fuzz_Stream[size], Fuzz_Resync_Packet, BLE_UART_PACKET_SIZE);
+    memcpy(&Fuzz_Stream[size + BLE_UART_PACKET_SIZE], Fuzz_Resync_Packet, BLE_UART_PACKET_SIZE);
+    Fuzz_Stream_Length = (uint32_t)size + 2 * BLE_UART_PACKET_SIZE;
+    Fuzz_Stream_Offset = 0;
+
+    HAL_Host_Reset();
+    BLE_UART_Init();
+    HAL_Host_Set_Poll_Hook(Fuzz_Poll_Hook);
+    HAL_Host_Set_Stall_Handler(Fuzz_Stalled);
+
+    // Allocated on the heap with the exact size so that the sanitizer catches any overflow
+    static char *buffer;
+    static uint8_t last_frame[BLE_UART_PACKET_SIZE];
+    static int last_length;
+
+    buffer = malloc(buffer_size);
+    last_length = 0;
+
+    if (setjmp(Fuzz_End) == 0) {
+        for (;;) {
+            int length = BLE_UART_InString(buffer, buffer_size);
+
+            if ((length < 0) || (length > buffer_size)) {
+                abort();
+            }
+
+            if ((length == BLE_UART_PACKET_SIZE) && ((buffer[0] != 0x21) || (buffer[1] != 0x47))) {
+                abort();
+            }
+
+            last_length = length;
+            memcpy(last_frame, buffer, (length < BLE_UART_PACKET_SIZE) ? length : BLE_UART_PACKET_SIZE);
+        }
+    }
+
+    free(buffer);
+
+    // A buffer that holds a full packet must end with the valid packet
+    if ((buffer_size >= BLE_UART_PACKET_SIZE) &&
+        ((last_length != BLE_UART_PACKET_SIZE) || (memcmp(last_frame, Fuzz_Resync_Packet, BLE_UART_PACKET_SIZE) != 0))) {
+        abort();
+    }
+
+    return 0;
+}
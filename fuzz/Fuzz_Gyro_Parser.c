@@ -0,0 +1,129 @@
+/**
+ * @file Fuzz_Gyro_Parser.c
+ * @brief Fuzzing harness for ValidateBLEPacket(), ValidateCRC(), ExtractFloat(), ExtractQ16(),
+ *        ParseBLEPacket() and ParseGyroPacket().
+ *
+ * The input is copied into a heap buffer of the exact input size, so that the address sanitizer
+ * catches any read past the end of the received bytes. The harness aborts if:
+ *
+ *  - ValidateBLEPacket(), ParseBLEPacket() and ParseGyroPacket() disagree, or accept anything
+ *    other than a 15-byte packet with the `!G` prefix and a valid checksum,
+ *
+ *  - ValidateCRC() disagrees with a reference checksum, or
+ *
+ *  - ExtractFloat() returns anything other than the four bytes at the offset for offsets inside
+ *    the packet, or anything other than 0 for offsets past the end of the packet,
+ *
+ *  - ExtractQ16() differs from the float conversion of the same bytes, rounded toward zero and
+ *    saturated, or ParseGyroPacket() returns other values than ExtractQ16().
+ *
+ * ValidateCRC(), ExtractFloat() and ExtractQ16() require a full packet, so they are only called on inputs of at
+ * least GYRO_PACKET_SIZE bytes.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/GyroParser.h"
+
+int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    // ParseBLEPacket() prints every packet
+    if (freopen("/dev/null", "w", stdout) == NULL) {
+        perror("/dev/null");
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reference conversion of a float to Q16.16, with double-precision arithmetic.
+ */
+static int32_t Reference_Q16(float value) {
+    if (isnan(value)) {
+        return 0;
+    }
+
+    double scaled = trunc((double)value * GYRO_Q16_ONE);
+
+    if (scaled >= GYRO_Q16_MAX) {
+        return GYRO_Q16_MAX;
+    }
+
+    if (scaled <= -GYRO_Q16_MAX) {
+        return -GYRO_Q16_MAX;
+    }
+
+    return (int32_t)scaled;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    uint8_t *packet = malloc(size ? size : 1);
+    uint16_t length = (size > 0xFFFF) ? 0xFFFF : (uint16_t)size;
+
+    memcpy(packet, data, size);
+
+    bool valid = ValidateBLEPacket(packet, length);
+
+    Gyro_Sample sample = {0};
+
+    if ((ParseBLEPacket(packet, length) != valid) || (ParseGyroPacket(packet, length, &sample) != valid)) {
+        abort();
+    }
+
+    if (size < GYRO_PACKET_SIZE) {
+        if (valid) {
+            abort();
+        }
+
+        free(packet);
+        return 0;
+    }
+
+    uint8_t sum = 0;
+
+    for (int i = 0; i < 14; i++) {
+        sum += packet[i];
+    }
+
+    bool crc = ((uint8_t)~sum == packet[14]);
+
+    if (ValidateCRC(packet) != crc) {
+        abort();
+    }
+
+    if (valid != ((size == GYRO_PACKET_SIZE) && (packet[0] == 0x21) && (packet[1] == 0x47) && crc)) {
+        abort();
+    }
+
+    for (int offset = 0; offset <= 0xFF; offset++) {
+        float value = ExtractFloat(packet, (uint8_t)offset);
+        uint32_t bits;
+        uint32_t expected = 0;
+
+        memcpy(&bits, &value, 4);
+
+        if (offset <= (GYRO_PACKET_SIZE - 4)) {
+            memcpy(&expected, &packet[offset], 4);
+        }
+
+        if (bits != expected) {
+            abort();
+        }
+
+        if (ExtractQ16(packet, (uint8_t)offset) != Reference_Q16(value)) {
+            abort();
+        }
+    }
+
+    if (valid && ((sample.X != ExtractQ16(packet, 2)) || (sample.Y != ExtractQ16(packet, 6)) ||
+                  (sample.Z != ExtractQ16(packet, 10)))) {
+        abort();
+    }
+
+    free(packet);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file Fuzz_Standalone.c
+ * @brief Standalone driver for the fuzzing harnesses when libFuzzer is not available.
+ *
+ * Runs the harness once for each file given on the command line, or once with the standard input
+ * if there are no arguments. This is the entry point used with AFL (afl-fuzz feeds each test case
+ * on the standard input or as a file) and to replay crashes and corpora with a compiler that does
+ * not provide libFuzzer.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int LLVMFuzzerInitialize(int *argc, char ***argv);
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/**
+ * @brief Reads a whole stream into a heap buffer.
+ *
+ * @return Pointer to the buffer (freed by the caller), or NULL on a read error.
+ */
+static uint8_t *Fuzz_Read(FILE *file, size_t *size) {
+    size_t capacity = 4096;
+    uint8_t *data = malloc(capacity);
+
+    *size = 0;
+
+    while (data != NULL) {
+        size_t count = fread(&data[*size], 1, capacity - *size, file);
+
+        *size += count;
+
+        if (count == 0) {
+            break;
+        }
+
+        if (*size == capacity) {
+            capacity *= 2;
+            data = realloc(data, capacity);
+        }
+    }
+
+    if ((data != NULL) && ferror(file)) {
+        free(data);
+        return NULL;
+    }
+
+    return data;
+}
+
+int main(int argc, char **argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    for (int i = (argc > 1) ? 1 : 0; i < argc; i++) {
+        FILE *file = (argc > 1) ? fopen(argv[i], "rb") : stdin;
+        size_t size;
+
+        if (file == NULL) {
+            perror(argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        uint8_t *data = Fuzz_Read(file, &size);
+
+        if (file != stdin) {
+            fclose(file);
+        }
+
+        if (data == NULL) {
+            fprintf(stderr, "fuzz: cannot read %s\n", (argc > 1) ? argv[i] : "standard input");
+            return EXIT_FAILURE;
+        }
+
+        LLVMFuzzerTestOneInput(data, size);
+        free(data);
+    }
+
+    return EXIT_SUCCESS;
+}
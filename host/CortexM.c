@@ -0,0 +1,41 @@
+/**
+ * @file CortexM.c
+ * @brief Host replacement for the Cortex-M interrupt control functions in src/CortexM.c.
+ *
+ * The assembly implementations of these functions cannot be compiled on the host. The functions
+ * below operate on the simulated PRIMASK register instead, and WaitForInterrupt() lets the
+ * simulated peripherals run for one poll.
+ *
+ * @author Aaron Nanas
+ */
+
+#include <stdint.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "../inc/CortexM.h"
+
+void DisableInterrupts(void)
+{
+    __disable_irq();
+}
+
+void EnableInterrupts(void)
+{
+    __enable_irq();
+}
+
+void StartCritical(void)
+{
+    // The previous I bit is returned in R0 on the target, which the host cannot model
+    __disable_irq();
+}
+
+void EndCritical(long sr)
+{
+    __set_PRIMASK((uint32_t)sr);
+}
+
+void WaitForInterrupt(void)
+{
+    HAL_Host_Poll();
+}
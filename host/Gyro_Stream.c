@@ -0,0 +1,199 @@
+/**
+ * @file Gyro_Stream.c
+ * @brief Source code for the simulated BLE gyroscope packet stream.
+ *
+ * The session moves the phone through slow sine waves with different periods on each axis, so
+ * that the stream passes through the forward, backward, left, right and stop regions used by
+ * MotorControlFromGyro().
+ *
+ * @author Nainika Saha
+ */
+
+#include <math.h>
+#include <string.h>
+#include "Gyro_Stream.h"
+
+#define GYRO_STREAM_PI 3.14159265f
+
+// Impairments that can be applied to a packet
+enum Gyro_Stream_Impairment {
+    GYRO_STREAM_NONE,
+    GYRO_STREAM_LOSS,
+    GYRO_STREAM_TRUNCATE,
+    GYRO_STREAM_BIT_ERROR,
+    GYRO_STREAM_GARBAGE
+};
+
+/**
+ * @brief Returns the next value of the xorshift32 generator.
+ *
+ * @param stream Pointer to the stream.
+ * @return A pseudo-random 32-bit value.
+ */
+static uint32_t Gyro_Stream_Random(Gyro_Stream *stream) {
+    uint32_t x = stream->Random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    stream->Random = x;
+    return x;
+}
+
+/**
+ * @brief Returns 1 with the given probability.
+ *
+ * @param stream Pointer to the stream.
+ * @param permille Probability in permille.
+ * @return 1 or 0.
+ */
+static uint8_t Gyro_Stream_Chance(Gyro_Stream *stream, uint16_t permille) {
+    return (permille > 0) && ((Gyro_Stream_Random(stream) % 1000) < permille);
+}
+
+/**
+ * @brief Returns approximately normally distributed noise with the configured standard deviation.
+ *
+ * Sums four uniform values (Irwin-Hall), which is close enough to a normal distribution for
+ * sensor noise and keeps the generator free of rejection loops.
+ *
+ * @param stream Pointer to the stream.
+ * @return The noise value.
+ */
+static float Gyro_Stream_Noise(Gyro_Stream *stream) {
+    if (stream->Config.Noise <= 0.0f) {
+        return 0.0f;
+    }
+
+    float sum = 0.0f;
+
+    for (int i = 0; i < 4; i++) {
+        sum += (float)(Gyro_Stream_Random(stream) >> 8) / 16777216.0f;
+    }
+
+    // The sum of four uniform values has a mean of 2 and a variance of 1/3
+    return (sum - 2.0f) * 1.7320508f * stream->Config.Noise;
+}
+
+/**
+ * @brief Chooses the impairment of the next packet, continuing the current burst if there is one.
+ *
+ * @param stream Pointer to the stream.
+ * @return The impairment to apply.
+ */
+static uint8_t Gyro_Stream_Choose_Impairment(Gyro_Stream *stream) {
+    if (stream->Burst_Remaining > 0) {
+        stream->Burst_Remaining--;
+        return stream->Burst_Type;
+    }
+
+    uint8_t type = GYRO_STREAM_NONE;
+
+    if (Gyro_Stream_Chance(stream, stream->Config.Loss_Permille)) {
+        type = GYRO_STREAM_LOSS;
+    } else if (Gyro_Stream_Chance(stream, stream->Config.Truncate_Permille)) {
+        type = GYRO_STREAM_TRUNCATE;
+    } else if (Gyro_Stream_Chance(stream, stream->Config.Bit_Error_Permille)) {
+        type = GYRO_STREAM_BIT_ERROR;
+    } else if (Gyro_Stream_Chance(stream, stream->Config.Garbage_Permille)) {
+        type = GYRO_STREAM_GARBAGE;
+    }
+
+    if ((type != GYRO_STREAM_NONE) && (stream->Config.Burst_Length > 1)) {
+        stream->Burst_Type = type;
+        stream->Burst_Remaining = stream->Config.Burst_Length - 1;
+    }
+
+    return type;
+}
+
+void Gyro_Stream_Default_Config(Gyro_Stream_Config *config) {
+    memset(config, 0, sizeof(*config));
+
+    config->Seed = 1;
+    config->Rate_Hz = 20;
+    config->Amplitude = 1.0f;
+    config->Burst_Length = 1;
+}
+
+void Gyro_Stream_Init(Gyro_Stream *stream, const Gyro_Stream_Config *config) {
+    memset(stream, 0, sizeof(*stream));
+
+    stream->Config = *config;
+
+    if (stream->Config.Rate_Hz == 0) {
+        stream->Config.Rate_Hz = 1;
+    }
+
+    // xorshift32 must not start from zero
+    stream->Random = (config->Seed != 0) ? config->Seed : 0x9E3779B9;
+}
+
+void Gyro_Stream_Encode(uint8_t *packet, float x, float y, float z) {
+    uint8_t sum = 0;
+
+    packet[0] = 0x21; // '!'
+    packet[1] = 0x47; // 'G'
+    memcpy(&packet[2], &x, 4);
+    memcpy(&packet[6], &y, 4);
+    memcpy(&packet[10], &z, 4);
+
+    // The checksum is the inverted sum of the first 14 bytes
+    for (int i = 0; i < 14; i++) {
+        sum += packet[i];
+    }
+
+    packet[14] = ~sum;
+}
+
+uint32_t Gyro_Stream_Next(Gyro_Stream *stream, uint8_t *buffer) {
+    float t = (float)stream->Index / (float)stream->Config.Rate_Hz;
+    float amplitude = stream->Config.Amplitude;
+    uint32_t length = 0;
+
+    stream->Index++;
+
+    // Tilt forward and backward every 20 s, sideways every 13 s, and rotate every 7 s
+    stream->X = amplitude * sinf(2.0f * GYRO_STREAM_PI * t / 13.0f) + Gyro_Stream_Noise(stream);
+    stream->Y = amplitude * sinf(2.0f * GYRO_STREAM_PI * t / 20.0f) + Gyro_Stream_Noise(stream);
+    stream->Z = 0.5f * amplitude * sinf(2.0f * GYRO_STREAM_PI * t / 7.0f) + Gyro_Stream_Noise(stream);
+
+    switch (Gyro_Stream_Choose_Impairment(stream)) {
+        case GYRO_STREAM_LOSS:
+            stream->Lost++;
+            return 0;
+
+        case GYRO_STREAM_GARBAGE: {
+            uint32_t count = 1 + (Gyro_Stream_Random(stream) % GYRO_STREAM_MAX_GARBAGE);
+
+            for (uint32_t i = 0; i < count; i++) {
+                buffer[length++] = (uint8_t)Gyro_Stream_Random(stream);
+            }
+
+            stream->Garbage_Bytes += count;
+            Gyro_Stream_Encode(&buffer[length], stream->X, stream->Y, stream->Z);
+            stream->Packets++;
+            return length + GYRO_STREAM_PACKET_SIZE;
+        }
+
+        case GYRO_STREAM_TRUNCATE:
+            Gyro_Stream_Encode(buffer, stream->X, stream->Y, stream->Z);
+            stream->Truncated++;
+            return 1 + (Gyro_Stream_Random(stream) % (GYRO_STREAM_PACKET_SIZE - 1));
+
+        case GYRO_STREAM_BIT_ERROR: {
+            uint32_t bit = Gyro_Stream_Random(stream) % (GYRO_STREAM_PACKET_SIZE * 8);
+
+            Gyro_Stream_Encode(buffer, stream->X, stream->Y, stream->Z);
+            buffer[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+            stream->Corrupted++;
+            return GYRO_STREAM_PACKET_SIZE;
+        }
+
+        default:
+            Gyro_Stream_Encode(buffer, stream->X, stream->Y, stream->Z);
+            stream->Packets++;
+            return GYRO_STREAM_PACKET_SIZE;
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file Gyro_Stream.h
+ * @brief Header file for the simulated BLE gyroscope packet stream.
+ *
+ * This file provides a deterministic generator for the `!G` packets that the Bluefruit Connect app
+ * sends in Controller mode. The generator synthesizes a smooth driving session (the phone tilting
+ * forward, backward and sideways), adds noise to each axis, and can impair the stream with lost,
+ * truncated and corrupted packets and with random bytes between packets. The same seed and
+ * configuration always produce the same byte stream.
+ *
+ * @author Nainika Saha
+ */
+
+#ifndef GYRO_STREAM_H
+#define GYRO_STREAM_H
+
+#include <stdint.h>
+
+#define GYRO_STREAM_PACKET_SIZE 15  ///< Size of a `!G` packet: prefix, three floats and the checksum
+#define GYRO_STREAM_MAX_GARBAGE 8   ///< Maximum number of random bytes inserted before a packet
+#define GYRO_STREAM_MAX_BYTES (GYRO_STREAM_MAX_GARBAGE + GYRO_STREAM_PACKET_SIZE) ///< Maximum bytes per packet period
+
+/**
+ * @brief Configuration of the generated stream.
+ *
+ * The impairment probabilities are given in permille (0 to 1000) per packet.
+ */
+typedef struct {
+    uint32_t Seed;                ///< Seed of the pseudo-random number generator
+    uint16_t Rate_Hz;             ///< Packets per second of the synthesized session
+    float Amplitude;              ///< Peak tilt of the X and Y axes
+    float Noise;                  ///< Standard deviation of the noise added to each axis
+    uint16_t Loss_Permille;       ///< Probability that a packet is lost
+    uint16_t Truncate_Permille;   ///< Probability that a packet is cut short
+    uint16_t Bit_Error_Permille;  ///< Probability that one bit of a packet is flipped
+    uint16_t Garbage_Permille;    ///< Probability that random bytes are inserted before a packet
+    uint16_t Burst_Length;        ///< Number of consecutive packets affected once an impairment occurs
+} Gyro_Stream_Config;
+
+/**
+ * @brief State and statistics of a generated stream.
+ */
+typedef struct {
+    Gyro_Stream_Config Config;
+    uint32_t Random;              ///< State of the xorshift32 generator
+    uint32_t Index;               ///< Number of packet periods generated
+    uint16_t Burst_Remaining;     ///< Packets left in the current impairment burst
+    uint8_t Burst_Type;           ///< Impairment applied during the current burst
+    uint32_t Packets;             ///< Complete and unmodified packets
+    uint32_t Lost;                ///< Packets that were dropped
+    uint32_t Truncated;           ///< Packets that were cut short
+    uint32_t Corrupted;           ///< Packets with a flipped bit
+    uint32_t Garbage_Bytes;       ///< Random bytes inserted between packets
+    float X;                      ///< X-axis value of the last packet
+    float Y;                      ///< Y-axis value of the last packet
+    float Z;                      ///< Z-axis value of the last packet
+} Gyro_Stream;
+
+/**
+ * @brief Fills a configuration with the defaults: 20 Hz, no noise and no impairments.
+ *
+ * @param config Pointer to the configuration.
+ */
+void Gyro_Stream_Default_Config(Gyro_Stream_Config *config);
+
+/**
+ * @brief Starts a new stream with the given configuration.
+ *
+ * @param stream Pointer to the stream.
+ * @param config Pointer to the configuration (copied into the stream).
+ */
+void Gyro_Stream_Init(Gyro_Stream *stream, const Gyro_Stream_Config *config);
+
+/**
+ * @brief Encodes a valid `!G` packet with the Adafruit checksum.
+ *
+ * @param packet Pointer to a buffer of at least GYRO_STREAM_PACKET_SIZE bytes.
+ * @param x X-axis value.
+ * @param y Y-axis value.
+ * @param z Z-axis value.
+ */
+void Gyro_Stream_Encode(uint8_t *packet, float x, float y, float z);
+
+/**
+ * @brief Generates the bytes sent during the next packet period.
+ *
+ * @param stream Pointer to the stream.
+ * @param buffer Pointer to a buffer of at least GYRO_STREAM_MAX_BYTES bytes.
+ * @return The number of bytes written to the buffer (0 if the packet was lost).
+ */
+uint32_t Gyro_Stream_Next(Gyro_Stream *stream, uint8_t *buffer);
+
+#endif // GYRO_STREAM_H
@@ -0,0 +1,399 @@
+/**
+ * @file HAL_Host.c
+ * @brief Source code for the host simulation backend of the hardware abstraction layer.
+ *
+ * This file defines the simulated register file declared in host/msp.h and the peripheral models
+ * described in HAL_Host.h.
+ *
+ * @author Aaron Nanas
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "file.h"
+#include "HAL_Host.h"
+
+// Simulated register blocks
+ADC14_Type HAL_Host_ADC14;
+CS_Type HAL_Host_CS;
+PCM_Type HAL_Host_PCM;
+FLCTL_Type HAL_Host_FLCTL;
+DIO_PORT_Interruptable_Type HAL_Host_Ports[10];
+DIO_PORT_Not_Interruptable_Type HAL_Host_PJ;
+EUSCI_A_Type HAL_Host_EUSCI_A[4];
+EUSCI_B_Type HAL_Host_EUSCI_B[4];
+Timer_A_Type HAL_Host_Timer_A[4];
+Timer32_Type HAL_Host_Timer32[2];
+NVIC_Type HAL_Host_NVIC;
+SCB_Type HAL_Host_SCB;
+SysTick_Type HAL_Host_SysTick;
+DWT_Type HAL_Host_DWT;
+CoreDebug_Type HAL_Host_CoreDebug;
+
+volatile uint32_t HAL_Host_PRIMASK = 0;
+
+// Number of simulated eUSCI modules (A0-A3 followed by B0-B3)
+#define HAL_HOST_EUSCI_COUNT 8
+
+typedef struct
+{
+    uint8_t Data[HAL_HOST_FIFO_SIZE];
+    uint32_t Head;
+    uint32_t Count;
+} HAL_Host_FIFO;
+
+typedef struct
+{
+    volatile uint16_t *RXBUF;
+    volatile uint16_t *IFG;
+    HAL_Host_FIFO RX;
+    HAL_Host_FIFO TX;
+    void (*TX_Handler)(uint8_t data);
+} HAL_Host_EUSCI;
+
+static HAL_Host_EUSCI HAL_Host_EUSCI_Modules[HAL_HOST_EUSCI_COUNT];
+
+// Values converted by the simulated ADC14 for each analog input channel
+static uint16_t HAL_Host_ADC_Inputs[32];
+
+static uint64_t HAL_Host_Cycles = 0;
+
+static uint32_t HAL_Host_Stalled_Polls = 0;
+
+static void (*HAL_Host_Poll_Hook)(void) = NULL;
+
+static void (*HAL_Host_Stall_Handler)(void) = NULL;
+
+/**
+ * @brief Returns the simulation state of an eUSCI module.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ *
+ * @return Pointer to the simulation state. Exits if the pointer is not an eUSCI module.
+ */
+static HAL_Host_EUSCI *HAL_Host_Get_EUSCI(volatile void *module)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (module == (volatile void *)&HAL_Host_EUSCI_A[i])
+        {
+            return &HAL_Host_EUSCI_Modules[i];
+        }
+
+        if (module == (volatile void *)&HAL_Host_EUSCI_B[i])
+        {
+            return &HAL_Host_EUSCI_Modules[4 + i];
+        }
+    }
+
+    fprintf(stderr, "HAL_Host: %p is not an eUSCI module\n", (void *)module);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Adds a byte to a FIFO.
+ *
+ * @param fifo Pointer to the FIFO.
+ * @param data The byte to add.
+ * @param overwrite 1 to drop the oldest byte if the FIFO is full, 0 to reject the new byte.
+ *
+ * @return 0x01 if the byte was added, 0x00 if the FIFO was full.
+ */
+static uint8_t HAL_Host_FIFO_Put(HAL_Host_FIFO *fifo, uint8_t data, uint8_t overwrite)
+{
+    if (fifo->Count == HAL_HOST_FIFO_SIZE)
+    {
+        if (!overwrite)
+        {
+            return 0x00;
+        }
+
+        fifo->Head = (fifo->Head + 1) % HAL_HOST_FIFO_SIZE;
+        fifo->Count--;
+    }
+
+    fifo->Data[(fifo->Head + fifo->Count) % HAL_HOST_FIFO_SIZE] = data;
+    fifo->Count++;
+
+    return 0x01;
+}
+
+/**
+ * @brief Removes the oldest byte from a FIFO.
+ *
+ * @param fifo Pointer to the FIFO.
+ * @param data Pointer to store the removed byte.
+ *
+ * @return 0x01 if a byte was removed, 0x00 if the FIFO was empty.
+ */
+static uint8_t HAL_Host_FIFO_Get(HAL_Host_FIFO *fifo, uint8_t *data)
+{
+    if (fifo->Count == 0)
+    {
+        return 0x00;
+    }
+
+    *data = fifo->Data[fifo->Head];
+    fifo->Head = (fifo->Head + 1) % HAL_HOST_FIFO_SIZE;
+    fifo->Count--;
+
+    return 0x01;
+}
+
+/**
+ * @brief Default stall handler that reports the stall and exits.
+ *
+ * @return None
+ */
+static void HAL_Host_Default_Stall_Handler(void)
+{
+    fprintf(stderr, "HAL_Host: stalled waiting for a peripheral for %d polls\n", HAL_HOST_STALL_POLLS);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Puts the simulation in its power-on state before main() runs.
+ *
+ * @return None
+ */
+__attribute__((constructor)) static void HAL_Host_Power_On(void)
+{
+    HAL_Host_Reset();
+}
+
+void HAL_Host_Reset(void)
+{
+    memset(&HAL_Host_ADC14, 0, sizeof(HAL_Host_ADC14));
+    memset(&HAL_Host_CS, 0, sizeof(HAL_Host_CS));
+    memset(&HAL_Host_PCM, 0, sizeof(HAL_Host_PCM));
+    memset(&HAL_Host_FLCTL, 0, sizeof(HAL_Host_FLCTL));
+    memset(HAL_Host_Ports, 0, sizeof(HAL_Host_Ports));
+    memset(&HAL_Host_PJ, 0, sizeof(HAL_Host_PJ));
+    memset(HAL_Host_EUSCI_A, 0, sizeof(HAL_Host_EUSCI_A));
+    memset(HAL_Host_EUSCI_B, 0, sizeof(HAL_Host_EUSCI_B));
+    memset(HAL_Host_Timer_A, 0, sizeof(HAL_Host_Timer_A));
+    memset(HAL_Host_Timer32, 0, sizeof(HAL_Host_Timer32));
+    memset(&HAL_Host_NVIC, 0, sizeof(HAL_Host_NVIC));
+    memset(&HAL_Host_SCB, 0, sizeof(HAL_Host_SCB));
+    memset(&HAL_Host_SysTick, 0, sizeof(HAL_Host_SysTick));
+    memset(&HAL_Host_DWT, 0, sizeof(HAL_Host_DWT));
+    memset(&HAL_Host_CoreDebug, 0, sizeof(HAL_Host_CoreDebug));
+    memset(HAL_Host_EUSCI_Modules, 0, sizeof(HAL_Host_EUSCI_Modules));
+    memset(HAL_Host_ADC_Inputs, 0, sizeof(HAL_Host_ADC_Inputs));
+
+    for (int i = 0; i < 4; i++)
+    {
+        HAL_Host_EUSCI_Modules[i].RXBUF = &HAL_Host_EUSCI_A[i].RXBUF;
+        HAL_Host_EUSCI_Modules[i].IFG = &HAL_Host_EUSCI_A[i].IFG;
+        HAL_Host_EUSCI_Modules[4 + i].RXBUF = &HAL_Host_EUSCI_B[i].RXBUF;
+        HAL_Host_EUSCI_Modules[4 + i].IFG = &HAL_Host_EUSCI_B[i].IFG;
+
+        // The Transmit Buffer is always empty (UCTXIFG is set)
+        HAL_Host_EUSCI_A[i].IFG = 0x0002;
+        HAL_Host_EUSCI_B[i].IFG = 0x0002;
+    }
+
+    // Report the power active mode requested by Clock_Init48MHz() (AM_LDO_VCORE1) as the current mode
+    HAL_Host_PCM.CTL0 = 0x00000100;
+
+    HAL_Host_PRIMASK = 0;
+    HAL_Host_Cycles = 0;
+    HAL_Host_Stalled_Polls = 0;
+    HAL_Host_Poll_Hook = NULL;
+    HAL_Host_Stall_Handler = NULL;
+}
+
+void HAL_Host_Poll(void)
+{
+    uint8_t progress = 0;
+
+    HAL_Host_Advance(HAL_HOST_POLL_CYCLES);
+
+    if (HAL_Host_Poll_Hook != NULL)
+    {
+        HAL_Host_Poll_Hook();
+    }
+
+    // Move the next received byte into RXBUF once the previous byte has been read
+    for (int i = 0; i < HAL_HOST_EUSCI_COUNT; i++)
+    {
+        HAL_Host_EUSCI *eusci = &HAL_Host_EUSCI_Modules[i];
+        uint8_t data;
+
+        if (((*eusci->IFG & 0x0001) == 0) && HAL_Host_FIFO_Get(&eusci->RX, &data))
+        {
+            *eusci->RXBUF = data;
+            *eusci->IFG |= 0x0001;
+            progress = 1;
+        }
+    }
+
+    // Complete the pending START and STOP conditions of the I2C modules
+    for (int i = 0; i < 4; i++)
+    {
+        if ((HAL_Host_EUSCI_B[i].CTLW0 & 0x0006) || (HAL_Host_EUSCI_B[i].STATW & 0x0010))
+        {
+            HAL_Host_EUSCI_B[i].CTLW0 &= ~0x0006;
+            HAL_Host_EUSCI_B[i].STATW &= ~0x0010;
+            progress = 1;
+        }
+    }
+
+    // Complete a conversion started with ADC14SC (Bit 0), starting at the CSTARTADDx address
+    if (HAL_Host_ADC14.CTL0 & 0x00000001)
+    {
+        uint32_t index = (HAL_Host_ADC14.CTL1 >> 16) & 0x1F;
+        uint8_t sequence = (HAL_Host_ADC14.CTL0 & 0x00060000) != 0;
+
+        while (index < 32)
+        {
+            uint32_t control = HAL_Host_ADC14.MCTL[index];
+
+            HAL_Host_ADC14.MEM[index] = HAL_Host_ADC_Inputs[control & 0x1F];
+            HAL_Host_ADC14.IFGR0 |= (1u << index);
+
+            // Stop at the end of the sequence (ADC14EOS, Bit 7) or after a single conversion
+            if (!sequence || (control & 0x80))
+            {
+                break;
+            }
+
+            index++;
+        }
+
+        HAL_Host_ADC14.CTL0 &= ~0x00010001;
+        progress = 1;
+    }
+
+    if (progress)
+    {
+        HAL_Host_Stalled_Polls = 0;
+    }
+    else if (++HAL_Host_Stalled_Polls >= HAL_HOST_STALL_POLLS)
+    {
+        HAL_Host_Stalled_Polls = 0;
+
+        if (HAL_Host_Stall_Handler != NULL)
+        {
+            HAL_Host_Stall_Handler();
+        }
+        else
+        {
+            HAL_Host_Default_Stall_Handler();
+        }
+    }
+}
+
+void HAL_Host_Advance(uint32_t cycles)
+{
+    HAL_Host_Cycles += cycles;
+
+    // The cycle counter only runs while CYCCNTENA (Bit 0) is set
+    if (HAL_Host_DWT.CTRL & 0x00000001)
+    {
+        HAL_Host_DWT.CYCCNT += cycles;
+    }
+}
+
+uint64_t HAL_Host_Get_Cycles(void)
+{
+    return HAL_Host_Cycles;
+}
+
+void HAL_Host_Set_Poll_Hook(void (*hook)(void))
+{
+    HAL_Host_Poll_Hook = hook;
+}
+
+void HAL_Host_Set_Stall_Handler(void (*handler)(void))
+{
+    HAL_Host_Stall_Handler = handler;
+}
+
+uint16_t HAL_Host_Read_RXBUF(volatile void *module)
+{
+    HAL_Host_EUSCI *eusci = HAL_Host_Get_EUSCI(module);
+
+    // Reading RXBUF clears UCRXIFG (Bit 0)
+    *eusci->IFG &= ~0x0001;
+    HAL_Host_Stalled_Polls = 0;
+
+    return *eusci->RXBUF;
+}
+
+void HAL_Host_Write_TXBUF(volatile void *module, uint16_t data)
+{
+    HAL_Host_EUSCI *eusci = HAL_Host_Get_EUSCI(module);
+
+    HAL_Host_Stalled_Polls = 0;
+
+    if (eusci->TX_Handler != NULL)
+    {
+        eusci->TX_Handler((uint8_t)data);
+    }
+    else
+    {
+        HAL_Host_FIFO_Put(&eusci->TX, (uint8_t)data, 1);
+    }
+}
+
+uint32_t HAL_Host_EUSCI_Feed(volatile void *module, const uint8_t *data, uint32_t length)
+{
+    HAL_Host_EUSCI *eusci = HAL_Host_Get_EUSCI(module);
+    uint32_t count = 0;
+
+    while ((count < length) && HAL_Host_FIFO_Put(&eusci->RX, data[count], 0))
+    {
+        count++;
+    }
+
+    if (count > 0)
+    {
+        HAL_Host_Stalled_Polls = 0;
+    }
+
+    return count;
+}
+
+uint32_t HAL_Host_EUSCI_Drain(volatile void *module, uint8_t *data, uint32_t max_length)
+{
+    HAL_Host_EUSCI *eusci = HAL_Host_Get_EUSCI(module);
+    uint32_t count = 0;
+
+    while ((count < max_length) && HAL_Host_FIFO_Get(&eusci->TX, &data[count]))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+uint32_t HAL_Host_EUSCI_Pending(volatile void *module)
+{
+    return HAL_Host_Get_EUSCI(module)->RX.Count;
+}
+
+void HAL_Host_Set_TX_Handler(volatile void *module, void (*handler)(uint8_t data))
+{
+    HAL_Host_Get_EUSCI(module)->TX_Handler = handler;
+}
+
+void HAL_Host_Set_ADC_Input(uint8_t channel, uint16_t value)
+{
+    HAL_Host_ADC_Inputs[channel & 0x1F] = value & 0x3FFF;
+}
+
+int add_device(char *name,
+               unsigned flags,
+               int (*dopen)(const char *path, unsigned flags, int llv_fd),
+               int (*dclose)(int dev_fd),
+               int (*dread)(int dev_fd, char *buf, unsigned count),
+               int (*dwrite)(int dev_fd, const char *buf, unsigned count),
+               off_t (*dlseek)(int dev_fd, off_t offset, int origin),
+               int (*dunlink)(const char *path),
+               int (*drename)(const char *old_name, const char *new_name))
+{
+    return -1;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file HAL_Host.h
+ * @brief Header file for the host simulation backend of the hardware abstraction layer.
+ *
+ * The host backend provides the simulated register file declared in host/msp.h together with
+ * simple models of the peripheral behavior that the drivers wait for:
+ *
+ *  - eUSCI modules (A0-A3, B0-B3): each module has a receive FIFO that the simulation feeds and
+ *    a transmit FIFO that collects the bytes written to TXBUF. A received byte is moved into RXBUF
+ *    and UCRXIFG is set when the previous byte has been read. UCTXIFG is always set.
+ *
+ *  - I2C conditions: the UCTXSTT and UCTXSTP bits and the UCBBUSY flag are cleared on the next poll.
+ *
+ *  - ADC14: a conversion started with ADC14SC completes on the next poll, loading each memory
+ *    register of the sequence with the value assigned to its input channel.
+ *
+ *  - Power Control Manager: the requested active mode is reported immediately.
+ *
+ *  - Cycle counter: the simulated time advances on every poll and delay, and DWT->CYCCNT follows
+ *    it while the counter is enabled.
+ *
+ * Interrupt handlers are not dispatched automatically. A simulation calls the handlers of the
+ * drivers directly (e.g. TA3_N_IRQHandler) after setting up the register state of the event.
+ *
+ * @author Aaron Nanas
+ */
+
+#ifndef HOST_HAL_HOST_H_
+#define HOST_HAL_HOST_H_
+
+#include <stdint.h>
+
+// Size of the receive and transmit FIFOs of each simulated eUSCI module
+#define HAL_HOST_FIFO_SIZE 4096
+
+// Number of simulated MCLK cycles that pass during each poll (1 us at 48 MHz)
+#define HAL_HOST_POLL_CYCLES 48
+
+// Number of consecutive polls without progress before the stall handler is called
+#define HAL_HOST_STALL_POLLS 1000000
+
+/**
+ * @brief Resets the simulated register file, FIFOs, hooks and cycle counter to their power-on state.
+ *
+ * @return None
+ */
+void HAL_Host_Reset(void);
+
+/**
+ * @brief Lets the simulated peripherals run for HAL_HOST_POLL_CYCLES cycles.
+ *
+ * Called by HAL_WAIT_WHILE() while a driver waits for a peripheral. The poll hook is called first,
+ * then pending receive bytes, I2C conditions and ADC conversions are completed. If no progress is
+ * made for HAL_HOST_STALL_POLLS consecutive polls, the stall handler is called.
+ *
+ * @return None
+ */
+void HAL_Host_Poll(void);
+
+/**
+ * @brief Advances the simulated time by the given number of MCLK cycles.
+ *
+ * @param cycles The number of cycles to advance.
+ *
+ * @return None
+ */
+void HAL_Host_Advance(uint32_t cycles);
+
+/**
+ * @brief Returns the number of simulated MCLK cycles since the last reset.
+ *
+ * @return The 64-bit simulated cycle count.
+ */
+uint64_t HAL_Host_Get_Cycles(void);
+
+/**
+ * @brief Sets a function that is called on every poll, e.g. to feed data or step a plant model.
+ *
+ * @param hook Pointer to the hook function, or NULL to remove it.
+ *
+ * @return None
+ */
+void HAL_Host_Set_Poll_Hook(void (*hook)(void));
+
+/**
+ * @brief Sets the function that is called when a driver waits for a peripheral that never responds.
+ *
+ * The default handler prints a message and exits. A harness can replace it with a handler that
+ * returns control to the harness with longjmp(), e.g. when a recorded byte stream runs out.
+ *
+ * @param handler Pointer to the handler function, or NULL to restore the default handler.
+ *
+ * @return None
+ */
+void HAL_Host_Set_Stall_Handler(void (*handler)(void));
+
+/**
+ * @brief Reads the Receive Buffer of a simulated eUSCI module and clears its UCRXIFG flag.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ *
+ * @return The contents of RXBUF.
+ */
+uint16_t HAL_Host_Read_RXBUF(volatile void *module);
+
+/**
+ * @brief Writes a byte to the Transmit Buffer of a simulated eUSCI module.
+ *
+ * The byte is passed to the transmit handler of the module if one is set. Otherwise, it is added
+ * to the transmit FIFO, dropping the oldest byte if the FIFO is full.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ * @param data The byte to transmit.
+ *
+ * @return None
+ */
+void HAL_Host_Write_TXBUF(volatile void *module, uint16_t data);
+
+/**
+ * @brief Adds bytes to the receive FIFO of a simulated eUSCI module.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ * @param data Pointer to the bytes to receive.
+ * @param length The number of bytes.
+ *
+ * @return The number of bytes added (less than length if the FIFO is full).
+ */
+uint32_t HAL_Host_EUSCI_Feed(volatile void *module, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Removes bytes from the transmit FIFO of a simulated eUSCI module.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ * @param data Pointer to the buffer for the transmitted bytes.
+ * @param max_length The size of the buffer.
+ *
+ * @return The number of bytes copied to the buffer.
+ */
+uint32_t HAL_Host_EUSCI_Drain(volatile void *module, uint8_t *data, uint32_t max_length);
+
+/**
+ * @brief Returns the number of bytes in the receive FIFO of a simulated eUSCI module.
+ *
+ * The byte currently held in RXBUF is not included.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ *
+ * @return The number of bytes that have not been moved to RXBUF yet.
+ */
+uint32_t HAL_Host_EUSCI_Pending(volatile void *module);
+
+/**
+ * @brief Sets a function that receives every byte written to the Transmit Buffer of a module.
+ *
+ * @param module Pointer to the eUSCI module (EUSCI_Ax or EUSCI_Bx).
+ * @param handler Pointer to the handler function, or NULL to collect the bytes in the transmit FIFO.
+ *
+ * @return None
+ */
+void HAL_Host_Set_TX_Handler(volatile void *module, void (*handler)(uint8_t data));
+
+/**
+ * @brief Sets the value that the simulated ADC14 converts for an analog input channel.
+ *
+ * @param channel The analog input channel (0 to 31).
+ * @param value The 14-bit conversion result.
+ *
+ * @return None
+ */
+void HAL_Host_Set_ADC_Input(uint8_t channel, uint16_t value);
+
+#endif /* HOST_HAL_HOST_H_ */
@@ -0,0 +1,406 @@
+/**
+ * @file Plant_Model.c
+ * @brief Source code for the simulated differential-drive platform (motors, wheels and encoders).
+ *
+ * Each integration step computes the PWM high time of both motors exactly from the Timer_A0
+ * up/down count, applies the average voltage over the step and integrates the wheel speed with
+ * explicit Euler steps (the step is about a thousand times shorter than the mechanical time
+ * constant). The wheel angle is interpolated linearly within the step to place the encoder edges.
+ *
+ * @author Nainika Saha
+ */
+
+#include <math.h>
+#include <string.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "Plant_Model.h"
+
+#define PLANT_MODEL_PI 3.14159265358979323846
+
+// Largest number of Timer_A3 events handled in one integration step
+#define PLANT_MODEL_MAX_EVENTS 16
+
+// Interrupt handlers of the Timer_A3_Capture driver
+void TA3_0_IRQHandler(void);
+void TA3_N_IRQHandler(void);
+
+// Timer_A3 events that can occur during a step
+enum Plant_Model_Event_Type {
+    PLANT_MODEL_RIGHT_EDGE,
+    PLANT_MODEL_LEFT_EDGE,
+    PLANT_MODEL_OVERFLOW
+};
+
+typedef struct {
+    uint64_t Cycle;
+    uint8_t Type;
+    uint8_t Forward;
+} Plant_Model_Event;
+
+static Plant_Model_Config Plant_Config;
+static Plant_Model_State Plant_State;
+
+// Simulated cycle at which the model was started
+static uint64_t Plant_Start_Cycle;
+
+// Simulated cycle at which Timer_A3 was last cleared (counter value 0)
+static uint64_t Plant_Timer_A3_Start;
+
+// Number of Timer_A3 overflows since Plant_Timer_A3_Start
+static uint64_t Plant_Timer_A3_Overflows;
+
+/**
+ * @brief Returns the number of cycles that the output of a Toggle / Reset channel of Timer_A0 is high,
+ *        from timer tick 0 to the given tick.
+ *
+ * In up/down mode, the counter runs from 0 up to CCR[0] and back. The output is toggled at CCR[n]
+ * on the way down and on the way up and reset at CCR[0], so it is high while the counter is below
+ * CCR[n], i.e. for 2 * CCR[n] of the 2 * CCR[0] ticks of each period, centered on the count of 0.
+ */
+static double Plant_Model_PWM_High_Ticks(double ticks, double period, double duty) {
+    double count = floor(ticks / (2.0 * period));
+    double phase = ticks - count * 2.0 * period;
+    double high = count * 2.0 * duty;
+
+    high += (phase < duty) ? phase : duty;
+    high += (phase > 2.0 * period - duty) ? phase - (2.0 * period - duty) : 0.0;
+
+    return high;
+}
+
+/**
+ * @brief Returns the fraction of the given cycles during which a Timer_A0 PWM output is high.
+ *
+ * @param channel The capture/compare channel (3 or 4).
+ * @param start The first simulated cycle.
+ * @param end The simulated cycle after the last one.
+ */
+static double Plant_Model_PWM_Duty(uint8_t channel, uint64_t start, uint64_t end) {
+    uint16_t cctl = TIMER_A0->CCTL[channel];
+    uint16_t ctl = TIMER_A0->CTL;
+
+    // OUTMOD = 000b drives the output with the OUT bit, as used by Motor_Emergency_Stop()
+    if ((cctl & 0x00E0) == 0x0000) {
+        return (cctl & 0x0004) ? 1.0 : 0.0;
+    }
+
+    // Timer_A0_PWM only uses the Toggle / Reset output mode in up/down mode; anything else is treated as low
+    if (((cctl & 0x00E0) != 0x0040) || ((ctl & 0x0030) != 0x0030) || (TIMER_A0->CCR[0] == 0)) {
+        return 0.0;
+    }
+
+    double divider = (double)PLANT_MODEL_SMCLK_DIVIDER * (double)(1 << ((ctl >> 6) & 0x03)) * (double)((TIMER_A0->EX0 & 0x07) + 1);
+    double period = TIMER_A0->CCR[0];
+    double duty = (TIMER_A0->CCR[channel] < TIMER_A0->CCR[0]) ? TIMER_A0->CCR[channel] : period;
+    double high = Plant_Model_PWM_High_Ticks((double)end / divider, period, duty) -
+                  Plant_Model_PWM_High_Ticks((double)start / divider, period, duty);
+
+    return high * divider / (double)(end - start);
+}
+
+/**
+ * @brief Integrates the speed and angle of one wheel over a step.
+ *
+ * @param wheel Pointer to the wheel state.
+ * @param enabled 1 if the motor driver is awake (nSLEEP high), 0 if the motor coasts.
+ * @param reverse 1 if the direction pin selects the backward direction.
+ * @param duty Fraction of the step during which the PWM output is high.
+ * @param gain Scale of the motor torque.
+ * @param dt Length of the step (s).
+ */
+static void Plant_Model_Step_Wheel(Plant_Model_Wheel *wheel, uint8_t enabled, uint8_t reverse,
+                                   double duty, double gain, double dt) {
+    const Plant_Model_Config *config = &Plant_Config;
+    double speed = wheel->Speed;
+    double torque = 0.0;
+
+    wheel->Voltage = 0.0;
+    wheel->Current = 0.0;
+
+    // While enabled, the H-bridge applies the battery voltage during the PWM high time and
+    // shorts the motor (brakes) during the low time
+    if (enabled) {
+        wheel->Voltage = (reverse ? -duty : duty) * config->Battery_Voltage;
+        wheel->Current = (wheel->Voltage - config->Motor_Constant * speed) / config->Resistance;
+        torque = gain * config->Motor_Constant * wheel->Current;
+    }
+
+    torque -= config->Viscous_Friction * speed;
+
+    if (speed == 0.0) {
+        // Static friction holds the wheel until the torque exceeds it
+        if (fabs(torque) <= config->Coulomb_Friction) {
+            return;
+        }
+
+        torque -= (torque > 0.0) ? config->Coulomb_Friction : -config->Coulomb_Friction;
+    } else {
+        torque -= (speed > 0.0) ? config->Coulomb_Friction : -config->Coulomb_Friction;
+    }
+
+    double next = speed + torque * dt / config->Inertia;
+
+    // A wheel that reaches zero speed stops for the rest of the step, and only starts turning the
+    // other way on the next step if the drive torque overcomes the static friction
+    if (((speed > 0.0) && (next < 0.0)) || ((speed < 0.0) && (next > 0.0))) {
+        next = 0.0;
+    }
+
+    wheel->Speed = next;
+    wheel->Angle += 0.5 * (speed + next) * dt;
+}
+
+/**
+ * @brief Adds the encoder A rising edges of a wheel between two angles to the event list.
+ *
+ * Encoder A is high during the first half of each step and encoder B leads it by a quarter step,
+ * so B is high on the A rising edges while the wheel turns forward and low while it turns backward.
+ *
+ * @return The new number of events.
+ */
+static uint32_t Plant_Model_Add_Edges(Plant_Model_Event *events, uint32_t count, uint8_t type,
+                                      double angle_start, double angle_end, uint64_t start, uint64_t end) {
+    double steps = Plant_Config.Steps_Per_Revolution / (2.0 * PLANT_MODEL_PI);
+    double phase_start = angle_start * steps;
+    double phase_end = angle_end * steps;
+
+    if (phase_end == phase_start) {
+        return count;
+    }
+
+    uint8_t forward = (phase_end > phase_start);
+
+    // Forward, A rises when the phase reaches an integer; backward, when it falls below a half integer
+    double offset = forward ? 0.0 : 0.5;
+    double first = forward ? floor(phase_start) + 1.0 : floor(phase_end - offset) + 1.0;
+    double last = forward ? floor(phase_end) : floor(phase_start - offset);
+
+    for (double edge = first; (edge <= last) && (count < PLANT_MODEL_MAX_EVENTS); edge += 1.0) {
+        double fraction = (edge + offset - phase_start) / (phase_end - phase_start);
+
+        events[count].Cycle = start + (uint64_t)(fraction * (double)(end - start));
+        events[count].Type = type;
+        events[count].Forward = forward;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Returns the level of encoder A (Bit 0) and encoder B (Bit 1) at a wheel angle.
+ */
+static uint8_t Plant_Model_Encoder_Levels(double angle) {
+    double phase = angle * Plant_Config.Steps_Per_Revolution / (2.0 * PLANT_MODEL_PI);
+    double a = phase - floor(phase);
+    double b = (phase + 0.25) - floor(phase + 0.25);
+
+    return ((a < 0.5) ? 0x01 : 0x00) | ((b < 0.5) ? 0x02 : 0x00);
+}
+
+/**
+ * @brief Presents the encoder levels of both wheels on P10.4, P10.5, P5.0 and P5.2.
+ */
+static void Plant_Model_Set_Encoder_Pins(uint8_t left, uint8_t right) {
+    P10->IN = (P10->IN & ~0x30) | ((right & 0x01) << 4) | ((left & 0x01) << 5);
+    P5->IN = (P5->IN & ~0x05) | ((right & 0x02) >> 1) | ((left & 0x02) << 1);
+}
+
+/**
+ * @brief Captures an event in the Timer_A3 registers and calls its interrupt handler, if enabled.
+ */
+static void Plant_Model_Dispatch(const Plant_Model_Event *event) {
+    TIMER_A3->R = (uint16_t)((event->Cycle - Plant_Timer_A3_Start) / PLANT_MODEL_SMCLK_DIVIDER);
+
+    switch (event->Type) {
+        case PLANT_MODEL_RIGHT_EDGE:
+            // Encoder B is stable around the A rising edge
+            P5->IN = (P5->IN & ~0x01) | (event->Forward ? 0x01 : 0x00);
+            P10->IN |= 0x10;
+
+            if (TIMER_A3->CCTL[0] & 0x0100) {
+                TIMER_A3->CCTL[0] |= (TIMER_A3->CCTL[0] & 0x0001) ? 0x0002 : 0x0000;
+                TIMER_A3->CCR[0] = TIMER_A3->R;
+                TIMER_A3->CCTL[0] |= 0x0001;
+
+                if ((TIMER_A3->CCTL[0] & 0x0010) && (NVIC->ISER[0] & 0x00004000)) {
+                    TA3_0_IRQHandler();
+                }
+            }
+            break;
+
+        case PLANT_MODEL_LEFT_EDGE:
+            P5->IN = (P5->IN & ~0x04) | (event->Forward ? 0x04 : 0x00);
+            P10->IN |= 0x20;
+
+            if (TIMER_A3->CCTL[1] & 0x0100) {
+                TIMER_A3->CCTL[1] |= (TIMER_A3->CCTL[1] & 0x0001) ? 0x0002 : 0x0000;
+                TIMER_A3->CCR[1] = TIMER_A3->R;
+                TIMER_A3->CCTL[1] |= 0x0001;
+
+                // Reading IV in the handler clears the flag of the reported source
+                if ((TIMER_A3->CCTL[1] & 0x0010) && (NVIC->ISER[0] & 0x00008000)) {
+                    TIMER_A3->IV = 0x02;
+                    TA3_N_IRQHandler();
+                    TIMER_A3->CCTL[1] &= ~0x0001;
+                    TIMER_A3->IV = 0x00;
+                }
+            }
+            break;
+
+        default:
+            TIMER_A3->CTL |= 0x0001;
+
+            if ((TIMER_A3->CTL & 0x0002) && (NVIC->ISER[0] & 0x00008000)) {
+                TIMER_A3->IV = 0x0E;
+                TA3_N_IRQHandler();
+                TIMER_A3->CTL &= ~0x0001;
+                TIMER_A3->IV = 0x00;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Runs one integration step of at most PLANT_MODEL_STEP_CYCLES cycles.
+ */
+static void Plant_Model_Step(uint32_t cycles) {
+    uint64_t start = HAL_Host_Get_Cycles();
+    uint64_t end = start + cycles;
+    double dt = (double)cycles / (double)(PLANT_MODEL_SMCLK_DIVIDER * 12000000);
+
+    // The TACLR bit restarts Timer_A3 from 0 and clears itself
+    if (TIMER_A3->CTL & 0x0004) {
+        TIMER_A3->CTL &= ~0x0004;
+        Plant_Timer_A3_Start = start;
+        Plant_Timer_A3_Overflows = 0;
+    }
+
+    // Motor driver inputs: P3.7 / P5.4 / CCR[4] for the left motor, P3.6 / P5.5 / CCR[3] for the right motor
+    double left_angle = Plant_State.Left.Angle;
+    double right_angle = Plant_State.Right.Angle;
+
+    Plant_Model_Step_Wheel(&Plant_State.Left, (P3->OUT & 0x80) != 0, (P5->OUT & 0x10) != 0,
+                           Plant_Model_PWM_Duty(4, start, end), Plant_Config.Left_Gain, dt);
+    Plant_Model_Step_Wheel(&Plant_State.Right, (P3->OUT & 0x40) != 0, (P5->OUT & 0x20) != 0,
+                           Plant_Model_PWM_Duty(3, start, end), Plant_Config.Right_Gain, dt);
+
+    // Pose of the platform from the wheel travel
+    double radius = Plant_Config.Wheel_Circumference / (2.0 * PLANT_MODEL_PI);
+    double left_distance = (Plant_State.Left.Angle - left_angle) * radius;
+    double right_distance = (Plant_State.Right.Angle - right_angle) * radius;
+    double distance = 0.5 * (left_distance + right_distance);
+    double rotation = (right_distance - left_distance) / Plant_Config.Wheel_Base;
+
+    Plant_State.X += distance * cos(Plant_State.Theta + 0.5 * rotation);
+    Plant_State.Y += distance * sin(Plant_State.Theta + 0.5 * rotation);
+    Plant_State.Theta += rotation;
+    Plant_State.Linear_Velocity = 0.5 * radius * (Plant_State.Left.Speed + Plant_State.Right.Speed);
+    Plant_State.Angular_Velocity = radius * (Plant_State.Right.Speed - Plant_State.Left.Speed) / Plant_Config.Wheel_Base;
+
+    // Collect the encoder edges and timer overflows of the step
+    Plant_Model_Event events[PLANT_MODEL_MAX_EVENTS];
+    uint32_t count = 0;
+
+    count = Plant_Model_Add_Edges(events, count, PLANT_MODEL_RIGHT_EDGE, right_angle, Plant_State.Right.Angle, start, end);
+    count = Plant_Model_Add_Edges(events, count, PLANT_MODEL_LEFT_EDGE, left_angle, Plant_State.Left.Angle, start, end);
+
+    uint8_t running = (TIMER_A3->CTL & 0x0030) != 0;
+    uint64_t overflow_cycles = (uint64_t)0x10000 * PLANT_MODEL_SMCLK_DIVIDER;
+
+    while (running && (count < PLANT_MODEL_MAX_EVENTS) &&
+           (Plant_Timer_A3_Start + (Plant_Timer_A3_Overflows + 1) * overflow_cycles < end)) {
+        Plant_Timer_A3_Overflows++;
+        events[count].Cycle = Plant_Timer_A3_Start + Plant_Timer_A3_Overflows * overflow_cycles;
+        events[count].Type = PLANT_MODEL_OVERFLOW;
+        events[count].Forward = 0;
+        count++;
+    }
+
+    // Insertion sort by time (an edge at the same cycle as an overflow is handled after it)
+    for (uint32_t i = 1; i < count; i++) {
+        Plant_Model_Event event = events[i];
+        uint32_t j = i;
+
+        while ((j > 0) && ((events[j - 1].Cycle > event.Cycle) ||
+                           ((events[j - 1].Cycle == event.Cycle) && (event.Type == PLANT_MODEL_OVERFLOW)))) {
+            events[j] = events[j - 1];
+            j--;
+        }
+
+        events[j] = event;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        HAL_Host_Advance((uint32_t)(events[i].Cycle - HAL_Host_Get_Cycles()));
+
+        if (events[i].Type == PLANT_MODEL_RIGHT_EDGE) {
+            Plant_State.Right.Steps += events[i].Forward ? 1 : -1;
+            Plant_State.Right.Edges++;
+        } else if (events[i].Type == PLANT_MODEL_LEFT_EDGE) {
+            Plant_State.Left.Steps += events[i].Forward ? 1 : -1;
+            Plant_State.Left.Edges++;
+        }
+
+        if (running) {
+            Plant_Model_Dispatch(&events[i]);
+        }
+    }
+
+    HAL_Host_Advance((uint32_t)(end - HAL_Host_Get_Cycles()));
+
+    Plant_Model_Set_Encoder_Pins(Plant_Model_Encoder_Levels(Plant_State.Left.Angle),
+                                 Plant_Model_Encoder_Levels(Plant_State.Right.Angle));
+
+    if (running) {
+        TIMER_A3->R = (uint16_t)((end - Plant_Timer_A3_Start) / PLANT_MODEL_SMCLK_DIVIDER);
+    }
+
+    Plant_State.Cycles = end - Plant_Start_Cycle;
+}
+
+void Plant_Model_Default_Config(Plant_Model_Config *config) {
+    memset(config, 0, sizeof(*config));
+
+    config->Battery_Voltage = 7.2;
+    config->Resistance = 8.0;
+    config->Motor_Constant = 0.4;
+    config->Inertia = 4.0e-4;
+    config->Viscous_Friction = 0.002;
+    config->Coulomb_Friction = 0.02;
+    config->Left_Gain = 1.0;
+    config->Right_Gain = 1.0;
+    config->Wheel_Circumference = 0.220;
+    config->Wheel_Base = 0.140;
+    config->Steps_Per_Revolution = 360;
+}
+
+void Plant_Model_Init(const Plant_Model_Config *config) {
+    memset(&Plant_State, 0, sizeof(Plant_State));
+
+    Plant_Config = *config;
+
+    if (Plant_Config.Steps_Per_Revolution == 0) {
+        Plant_Config.Steps_Per_Revolution = 1;
+    }
+
+    Plant_Start_Cycle = HAL_Host_Get_Cycles();
+    Plant_Timer_A3_Start = Plant_Start_Cycle - (uint64_t)TIMER_A3->R * PLANT_MODEL_SMCLK_DIVIDER;
+    Plant_Timer_A3_Overflows = 0;
+
+    Plant_Model_Set_Encoder_Pins(Plant_Model_Encoder_Levels(0.0), Plant_Model_Encoder_Levels(0.0));
+}
+
+void Plant_Model_Advance(uint32_t cycles) {
+    while (cycles > 0) {
+        uint32_t step = (cycles < PLANT_MODEL_STEP_CYCLES) ? cycles : PLANT_MODEL_STEP_CYCLES;
+
+        Plant_Model_Step(step);
+        cycles -= step;
+    }
+}
+
+void Plant_Model_Get_State(Plant_Model_State *state) {
+    *state = Plant_State;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file Plant_Model.h
+ * @brief Header file for the simulated differential-drive platform (motors, wheels and encoders).
+ *
+ * The plant model closes the loop between the Motor and Tachometer drivers on the host. It reads
+ * the outputs that the Motor driver sets on the simulated register file and produces the encoder
+ * signals that the Tachometer driver measures:
+ *
+ *  - Inputs: the PWM waveforms of Timer_A0 CCR[3] (P2.6, right motor) and CCR[4] (P2.7, left
+ *    motor) in up/down mode, the direction pins P5.4 (left) and P5.5 (right), and the enable pins
+ *    P3.6 (right) and P3.7 (left). A disabled driver lets the motor coast; while enabled, the
+ *    PWM high time applies the battery voltage and the low time brakes the motor.
+ *
+ *  - Dynamics: each wheel is driven by a brushed DC motor through its gearbox, modeled at the
+ *    wheel shaft with the winding resistance, the back-EMF constant, viscous and Coulomb friction,
+ *    and the inertia of the rotor and half of the platform. The wheels do not slip, so the pose
+ *    follows from the wheel angles.
+ *
+ *  - Outputs: encoder A rising edges are captured by Timer_A3 (CCR[0] for the right wheel on P10.4,
+ *    CCR[1] for the left wheel on P10.5) at the exact simulated time of the edge, and encoder B is
+ *    presented on P5.0 (right) and P5.2 (left) with the phase of a quadrature encoder. Timer_A3
+ *    runs from SMCLK and reports its overflows, so the 32-bit capture times of the Tachometer
+ *    driver stay consistent with Timer_A3_Capture_Now().
+ *
+ * Plant_Model_Advance() is the clock of a plant simulation: it advances the simulated time and
+ * calls TA3_0_IRQHandler() and TA3_N_IRQHandler() in time order for the edges and overflows that
+ * occur, as the NVIC would. The simulation runs as fast as the host allows, typically more than a
+ * hundred times faster than real time.
+ *
+ * @note SMCLK is assumed to be MCLK / 4 (12 MHz at 48 MHz), as set up by Clock_Init48MHz().
+ *
+ * @author Nainika Saha
+ */
+
+#ifndef PLANT_MODEL_H
+#define PLANT_MODEL_H
+
+#include <stdint.h>
+
+#define PLANT_MODEL_SMCLK_DIVIDER 4     ///< MCLK cycles per SMCLK cycle
+#define PLANT_MODEL_STEP_CYCLES 960     ///< Integration step in MCLK cycles (20 us at 48 MHz)
+
+/**
+ * @brief Physical parameters of the platform.
+ *
+ * The motor constants are given at the wheel shaft, i.e. after the gearbox.
+ */
+typedef struct {
+    double Battery_Voltage;          ///< Supply voltage of the motor drivers (V)
+    double Resistance;               ///< Winding resistance (ohm)
+    double Motor_Constant;           ///< Torque constant and back-EMF constant (N m / A, V s / rad)
+    double Inertia;                  ///< Inertia of each wheel with its share of the platform (kg m^2)
+    double Viscous_Friction;         ///< Viscous friction (N m s / rad)
+    double Coulomb_Friction;         ///< Static and sliding friction torque (N m)
+    double Left_Gain;                ///< Scale of the left motor torque (gearbox efficiency), to model mismatched motors
+    double Right_Gain;               ///< Scale of the right motor torque
+    double Wheel_Circumference;      ///< Wheel circumference (m)
+    double Wheel_Base;               ///< Distance between the wheels (m)
+    uint16_t Steps_Per_Revolution;   ///< Encoder A rising edges per wheel revolution
+} Plant_Model_Config;
+
+/**
+ * @brief State of one wheel.
+ */
+typedef struct {
+    double Angle;                    ///< Wheel angle since the reset (rad, positive forward)
+    double Speed;                    ///< Angular speed (rad/s, positive forward)
+    double Voltage;                  ///< Average voltage applied during the last step (V)
+    double Current;                  ///< Winding current during the last step (A)
+    int32_t Steps;                   ///< Encoder A rising edges (incremented forward, decremented backward)
+    uint32_t Edges;                  ///< Encoder A rising edges in either direction
+} Plant_Model_Wheel;
+
+/**
+ * @brief Ground truth of the simulated platform.
+ */
+typedef struct {
+    Plant_Model_Wheel Left;
+    Plant_Model_Wheel Right;
+    double X;                        ///< Position relative to the starting point (m)
+    double Y;
+    double Theta;                    ///< Heading (rad, positive counterclockwise, not wrapped)
+    double Linear_Velocity;          ///< Forward velocity of the center of the platform (m/s)
+    double Angular_Velocity;         ///< Yaw rate (rad/s, positive counterclockwise)
+    uint64_t Cycles;                 ///< Simulated MCLK cycles since the reset
+} Plant_Model_State;
+
+/**
+ * @brief Fills a configuration with the parameters of the TI-RSLK MAX chassis.
+ *
+ * 120:1 gear motors on a 7.2 V battery (about 150 rpm without load), 70 mm wheels 140 mm apart
+ * and 360 encoder steps per wheel revolution, as assumed by the Odometry driver.
+ *
+ * @param config Pointer to the configuration.
+ */
+void Plant_Model_Default_Config(Plant_Model_Config *config);
+
+/**
+ * @brief Starts the model at rest at the origin with the given configuration.
+ *
+ * The encoder pins are set to the levels of a wheel at rest on an A rising edge. Timer_A3 keeps
+ * counting from its current value.
+ *
+ * @param config Pointer to the configuration (copied into the model).
+ */
+void Plant_Model_Init(const Plant_Model_Config *config);
+
+/**
+ * @brief Runs the plant for the given number of MCLK cycles.
+ *
+ * Advances the simulated time in steps of at most PLANT_MODEL_STEP_CYCLES, integrating the motor
+ * dynamics for the inputs set on the register file and dispatching the Timer_A3 interrupts of the
+ * encoder edges and timer overflows. The interrupts are only dispatched while they are enabled in
+ * the CCTL or CTL register and in the NVIC.
+ *
+ * @param cycles The number of cycles to run.
+ */
+void Plant_Model_Advance(uint32_t cycles);
+
+/**
+ * @brief Gets a copy of the ground truth of the platform.
+ *
+ * @param state Pointer to store the state.
+ */
+void Plant_Model_Get_State(Plant_Model_State *state);
+
+#endif // PLANT_MODEL_H
@@ -0,0 +1,35 @@
+/**
+ * @file file.h
+ * @brief Host replacement for the TI run-time support device table header.
+ *
+ * EUSCI_A0_UART_Init_Printf() registers the UART as a stdio device with add_device(). On the host,
+ * add_device() reports a failure so that printf() keeps writing to the standard output of the
+ * simulation.
+ *
+ * @author Aaron Nanas
+ */
+
+#ifndef HOST_FILE_H_
+#define HOST_FILE_H_
+
+#include <sys/types.h>
+
+#define _SSA    0x0000  ///< Device supports a single stream at a time
+#define _MSA    0x0001  ///< Device supports multiple streams at a time
+
+/**
+ * @brief Adds a device to the device table (not supported on the host).
+ *
+ * @return -1 to indicate that the device was not added.
+ */
+int add_device(char *name,
+               unsigned flags,
+               int (*dopen)(const char *path, unsigned flags, int llv_fd),
+               int (*dclose)(int dev_fd),
+               int (*dread)(int dev_fd, char *buf, unsigned count),
+               int (*dwrite)(int dev_fd, const char *buf, unsigned count),
+               off_t (*dlseek)(int dev_fd, off_t offset, int origin),
+               int (*dunlink)(const char *path),
+               int (*drename)(const char *old_name, const char *new_name));
+
+#endif /* HOST_FILE_H_ */
@@ -0,0 +1,290 @@
+/**
+ * @file msp.h
+ * @brief Simulated MSP432P401R register file for the host build.
+ *
+ * This header replaces the device header from the MSP432 SDK when the drivers are compiled on a
+ * host machine. It declares the peripheral register blocks used by the drivers with the same type
+ * and field names as the device header, backed by ordinary variables in host/HAL_Host.c instead of
+ * memory-mapped registers. The CMSIS intrinsics used for critical sections are modeled on a
+ * simulated PRIMASK register.
+ *
+ * Only the peripherals and fields that the drivers use are declared. The layout of each block does
+ * not match the device, since nothing on the host depends on the register addresses.
+ *
+ * @author Aaron Nanas
+ */
+
+#ifndef HOST_MSP_H_
+#define HOST_MSP_H_
+
+#include <stdint.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+typedef struct {
+    __IO uint32_t CTL0;
+    __IO uint32_t CTL1;
+    __IO uint32_t LO0;
+    __IO uint32_t HI0;
+    __IO uint32_t LO1;
+    __IO uint32_t HI1;
+    __IO uint32_t MCTL[32];
+    __IO uint32_t MEM[32];
+    __IO uint32_t IER0;
+    __IO uint32_t IER1;
+    __IO uint32_t IFGR0;
+    __IO uint32_t IFGR1;
+    __O  uint32_t CLRIFGR0;
+    __IO uint32_t CLRIFGR1;
+    __IO uint32_t IV;
+} ADC14_Type;
+
+typedef struct {
+    __IO uint32_t KEY;
+    __IO uint32_t CTL0;
+    __IO uint32_t CTL1;
+    __IO uint32_t CTL2;
+    __IO uint32_t CTL3;
+    __IO uint32_t CLKEN;
+    __IO uint32_t STAT;
+    __IO uint32_t IE;
+    __IO uint32_t IFG;
+    __O  uint32_t CLRIFG;
+    __O  uint32_t SETIFG;
+} CS_Type;
+
+typedef struct {
+    __IO uint32_t CTL0;
+    __IO uint32_t CTL1;
+    __IO uint32_t IE;
+    __IO uint32_t IFG;
+    __O  uint32_t CLRIFG;
+} PCM_Type;
+
+typedef struct {
+    __IO uint32_t BANK0_RDCTL;
+    __IO uint32_t BANK1_RDCTL;
+} FLCTL_Type;
+
+#define FLCTL_BANK0_RDCTL_WAIT_2    ((uint32_t)0x00002000)
+#define FLCTL_BANK1_RDCTL_WAIT_2    ((uint32_t)0x00002000)
+
+typedef struct {
+    __IO uint8_t IN;
+    __IO uint8_t OUT;
+    __IO uint8_t DIR;
+    __IO uint8_t REN;
+    __IO uint8_t DS;
+    __IO uint8_t SEL0;
+    __IO uint8_t SEL1;
+    __IO uint8_t SELC;
+    __IO uint8_t IES;
+    __IO uint8_t IE;
+    __IO uint8_t IFG;
+    __IO uint16_t IV;
+} DIO_PORT_Interruptable_Type;
+
+typedef DIO_PORT_Interruptable_Type DIO_PORT_Odd_Interruptable_Type;
+typedef DIO_PORT_Interruptable_Type DIO_PORT_Even_Interruptable_Type;
+
+typedef struct {
+    __IO uint8_t IN;
+    __IO uint8_t OUT;
+    __IO uint8_t DIR;
+    __IO uint8_t REN;
+    __IO uint8_t DS;
+    __IO uint8_t SEL0;
+    __IO uint8_t SEL1;
+    __IO uint8_t SELC;
+} DIO_PORT_Not_Interruptable_Type;
+
+typedef struct {
+    __IO uint16_t CTLW0;
+    __IO uint16_t CTLW1;
+    __IO uint16_t BRW;
+    __IO uint16_t MCTLW;
+    __IO uint16_t STATW;
+    __IO uint16_t RXBUF;
+    __IO uint16_t TXBUF;
+    __IO uint16_t ABCTL;
+    __IO uint16_t IRCTL;
+    __IO uint16_t IE;
+    __IO uint16_t IFG;
+    __IO uint16_t IV;
+} EUSCI_A_Type;
+
+typedef struct {
+    __IO uint16_t CTLW0;
+    __IO uint16_t CTLW1;
+    __IO uint16_t BRW;
+    __IO uint16_t STATW;
+    __IO uint16_t TBCNT;
+    __IO uint16_t RXBUF;
+    __IO uint16_t TXBUF;
+    __IO uint16_t I2COA0;
+    __IO uint16_t I2COA1;
+    __IO uint16_t I2COA2;
+    __IO uint16_t I2COA3;
+    __IO uint16_t ADDRX;
+    __IO uint16_t ADDMASK;
+    __IO uint16_t I2CSA;
+    __IO uint16_t IE;
+    __IO uint16_t IFG;
+    __IO uint16_t IV;
+} EUSCI_B_Type;
+
+typedef struct {
+    __IO uint16_t CTL;
+    __IO uint16_t CCTL[7];
+    __IO uint16_t R;
+    __IO uint16_t CCR[7];
+    __IO uint16_t EX0;
+    __IO uint16_t IV;
+} Timer_A_Type;
+
+typedef struct {
+    __IO uint32_t LOAD;
+    __IO uint32_t VALUE;
+    __IO uint32_t CONTROL;
+    __O  uint32_t INTCLR;
+    __IO uint32_t RIS;
+    __IO uint32_t MIS;
+    __IO uint32_t BGLOAD;
+} Timer32_Type;
+
+/*
+ * The drivers configure the NVIC priorities four interrupts at a time through 32-bit IP words,
+ * so IP is declared as an array of words rather than bytes.
+ */
+typedef struct {
+    __IO uint32_t ISER[8];
+    __IO uint32_t ICER[8];
+    __IO uint32_t ISPR[8];
+    __IO uint32_t ICPR[8];
+    __IO uint32_t IABR[8];
+    __IO uint32_t IP[60];
+} NVIC_Type;
+
+typedef struct {
+    __IO uint32_t CPUID;
+    __IO uint32_t ICSR;
+    __IO uint32_t VTOR;
+    __IO uint32_t AIRCR;
+    __IO uint32_t SCR;
+    __IO uint32_t CCR;
+    __IO uint8_t SHP[12];
+} SCB_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __IO uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+// Simulated register blocks (defined in host/HAL_Host.c)
+extern ADC14_Type HAL_Host_ADC14;
+extern CS_Type HAL_Host_CS;
+extern PCM_Type HAL_Host_PCM;
+extern FLCTL_Type HAL_Host_FLCTL;
+extern DIO_PORT_Interruptable_Type HAL_Host_Ports[10];
+extern DIO_PORT_Not_Interruptable_Type HAL_Host_PJ;
+extern EUSCI_A_Type HAL_Host_EUSCI_A[4];
+extern EUSCI_B_Type HAL_Host_EUSCI_B[4];
+extern Timer_A_Type HAL_Host_Timer_A[4];
+extern Timer32_Type HAL_Host_Timer32[2];
+extern NVIC_Type HAL_Host_NVIC;
+extern SCB_Type HAL_Host_SCB;
+extern SysTick_Type HAL_Host_SysTick;
+extern DWT_Type HAL_Host_DWT;
+extern CoreDebug_Type HAL_Host_CoreDebug;
+
+#define ADC14       (&HAL_Host_ADC14)
+#define CS          (&HAL_Host_CS)
+#define PCM         (&HAL_Host_PCM)
+#define FLCTL       (&HAL_Host_FLCTL)
+
+#define P1          (&HAL_Host_Ports[0])
+#define P2          (&HAL_Host_Ports[1])
+#define P3          (&HAL_Host_Ports[2])
+#define P4          (&HAL_Host_Ports[3])
+#define P5          (&HAL_Host_Ports[4])
+#define P6          (&HAL_Host_Ports[5])
+#define P7          (&HAL_Host_Ports[6])
+#define P8          (&HAL_Host_Ports[7])
+#define P9          (&HAL_Host_Ports[8])
+#define P10         (&HAL_Host_Ports[9])
+#define PJ          (&HAL_Host_PJ)
+
+#define EUSCI_A0    (&HAL_Host_EUSCI_A[0])
+#define EUSCI_A1    (&HAL_Host_EUSCI_A[1])
+#define EUSCI_A2    (&HAL_Host_EUSCI_A[2])
+#define EUSCI_A3    (&HAL_Host_EUSCI_A[3])
+#define EUSCI_B0    (&HAL_Host_EUSCI_B[0])
+#define EUSCI_B1    (&HAL_Host_EUSCI_B[1])
+#define EUSCI_B2    (&HAL_Host_EUSCI_B[2])
+#define EUSCI_B3    (&HAL_Host_EUSCI_B[3])
+
+#define TIMER_A0    (&HAL_Host_Timer_A[0])
+#define TIMER_A1    (&HAL_Host_Timer_A[1])
+#define TIMER_A2    (&HAL_Host_Timer_A[2])
+#define TIMER_A3    (&HAL_Host_Timer_A[3])
+#define TIMER32_1   (&HAL_Host_Timer32[0])
+#define TIMER32_2   (&HAL_Host_Timer32[1])
+
+#define NVIC        (&HAL_Host_NVIC)
+#define SCB         (&HAL_Host_SCB)
+#define SysTick     (&HAL_Host_SysTick)
+#define DWT         (&HAL_Host_DWT)
+#define CoreDebug   (&HAL_Host_CoreDebug)
+
+// Simulated PRIMASK register (1 when interrupts are disabled)
+extern volatile uint32_t HAL_Host_PRIMASK;
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return HAL_Host_PRIMASK;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+    HAL_Host_PRIMASK = priMask & 0x01;
+}
+
+static inline void __disable_irq(void)
+{
+    HAL_Host_PRIMASK = 1;
+}
+
+static inline void __enable_irq(void)
+{
+    HAL_Host_PRIMASK = 0;
+}
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __NOP(void)
+{
+}
+
+#endif /* HOST_MSP_H_ */
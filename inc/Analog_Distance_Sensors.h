@@ -27,6 +27,37 @@
 #define Cx 40
 #define ANALOG_DISTANCE_SENSOR_MAX 2552
 
+// Number of ADC counts covered by each segment of the distance lookup table (2^7 = 128)
+#define ANALOG_DISTANCE_LUT_SHIFT 7
+
+// Number of breakpoints in the distance lookup table
+// The 14-bit ADC range (0 to 16383) is split into 128 segments, which requires 129 breakpoints
+#define ANALOG_DISTANCE_LUT_SIZE ((16384 >> ANALOG_DISTANCE_LUT_SHIFT) + 1)
+
+// Maximum number of calibration points that can be captured for each sensor
+#define ANALOG_DISTANCE_CALIBRATION_MAX_POINTS 8
+
+/**
+ * @brief Identifies each of the three Sharp GP2Y0A21YK0F Analog Distance Sensors
+ */
+enum Analog_Distance_Sensor_Index
+{
+    ANALOG_DISTANCE_SENSOR_RIGHT,
+    ANALOG_DISTANCE_SENSOR_CENTER,
+    ANALOG_DISTANCE_SENSOR_LEFT,
+    ANALOG_DISTANCE_SENSOR_COUNT
+};
+
+/**
+ * @brief Coefficients of the calibration formula Dx = (A / (filtered_distance + B) + C) for one sensor
+ */
+typedef struct
+{
+    int32_t A;
+    int32_t B;
+    int32_t C;
+} Analog_Distance_Sensor_Coefficients;
+
 /**
  * @brief Initialize the Sharp GP2Y0A21YK0F Analog Distance Sensors and configure ADC14 settings.
  *
@@ -58,14 +89,101 @@ void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, u
  * @brief Calibrate the distance sensor reading based on a filtered distance value.
  *
  * This function calibrates the distance sensor reading based on a filtered distance value.
- * It applies a calibration formula to adjust the sensor data, providing a calibrated result.
- * The following calibration formula is used:
+ * It looks up the result in a piecewise-linear table that the compiler computes
+ * from the default calibration formula, so no division is performed at run time:
  *  Dx = (Ax / (filtered_distance + Bx) + Cx)
  *
- * @param filtered_distance The filtered distance value obtained from the sensor.
+ * @param filtered_distance The filtered distance value obtained from the sensor (0 to 16383). Larger values
+ *                          are limited to 16383.
  *
- * @return Calibrated distance value, or 800 if the filtered distance is less than ANALOG_DISTANCE_SENSOR_MAX.
+ * @return Calibrated distance value in mm, or 800 if the filtered distance is less than ANALOG_DISTANCE_SENSOR_MAX.
  */
 int32_t Analog_Distance_Sensor_Calibrate(int filtered_distance);
 
+/**
+ * @brief Convert a filtered reading from a specific sensor into a distance using that sensor's lookup table.
+ *
+ * The 14-bit reading is split into a table index (upper 7 bits) and an interpolation fraction (lower 7 bits).
+ * The result is interpolated linearly between two adjacent breakpoints using only a multiply and a shift.
+ *
+ * @param sensor The sensor that produced the reading (see Analog_Distance_Sensor_Index).
+ *
+ * @param filtered_distance The filtered distance value obtained from the sensor (0 to 16383). Larger values
+ *                          are limited to 16383.
+ *
+ * @note The per-sensor tables hold the default calibration until Analog_Distance_Sensor_Calibration_Fit() succeeds.
+ *
+ * @return Calibrated distance value in mm (at most 800).
+ */
+int32_t Analog_Distance_Sensor_Convert(enum Analog_Distance_Sensor_Index sensor, uint32_t filtered_distance);
+
+/**
+ * @brief Regenerate the lookup table of a sensor from a set of calibration coefficients.
+ *
+ * @param sensor The sensor whose lookup table will be replaced.
+ *
+ * @param coefficients The A, B, and C coefficients of the calibration formula.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_Build_Table(enum Analog_Distance_Sensor_Index sensor, Analog_Distance_Sensor_Coefficients coefficients);
+
+/**
+ * @brief Discard all of the calibration points captured for a sensor.
+ *
+ * @param sensor The sensor whose calibration points will be discarded.
+ *
+ * @return None
+ */
+void Analog_Distance_Sensor_Calibration_Reset(enum Analog_Distance_Sensor_Index sensor);
+
+/**
+ * @brief Capture a calibration point while a target is placed at a known distance from a sensor.
+ *
+ * This function runs the specified number of ADC conversions, averages the readings of the selected sensor,
+ * and stores the result together with the known distance. At most ANALOG_DISTANCE_CALIBRATION_MAX_POINTS
+ * points are kept for each sensor.
+ *
+ * @param sensor The sensor that is being calibrated.
+ *
+ * @param actual_distance The measured distance between the sensor and the target in mm.
+ *
+ * @param num_samples The number of ADC conversions to average (must be non-zero).
+ *
+ * @note Assumes that Analog_Distance_Sensor_Init() has been called.
+ *
+ * @return 0x01 if the point was stored. Otherwise, returns 0x00.
+ */
+uint8_t Analog_Distance_Sensor_Calibration_Capture(enum Analog_Distance_Sensor_Index sensor, int32_t actual_distance, uint16_t num_samples);
+
+/**
+ * @brief Store a calibration point whose reading has already been obtained.
+ *
+ * @param sensor The sensor that is being calibrated.
+ *
+ * @param filtered_distance The filtered reading from the sensor (0 to 16383).
+ *
+ * @param actual_distance The measured distance between the sensor and the target in mm.
+ *
+ * @return 0x01 if the point was stored. Otherwise, returns 0x00.
+ */
+uint8_t Analog_Distance_Sensor_Calibration_Add_Point(enum Analog_Distance_Sensor_Index sensor, uint32_t filtered_distance, int32_t actual_distance);
+
+/**
+ * @brief Fit the A and B coefficients of a sensor to its captured calibration points.
+ *
+ * The C coefficient is held at Cx. Rearranging the calibration formula as
+ * (Dx - C) * x = A - B * (Dx - C) makes it linear in A and B, so an integer least-squares fit is used.
+ * On success, the sensor's lookup table is regenerated from the fitted coefficients.
+ *
+ * @param sensor The sensor that is being calibrated.
+ *
+ * @param coefficients Pointer to store the fitted coefficients. May be NULL.
+ *
+ * @note At least two points with different distances (each greater than Cx) are required.
+ *
+ * @return 0x01 if the fit succeeded. Otherwise, returns 0x00 and the lookup table is left unchanged.
+ */
+uint8_t Analog_Distance_Sensor_Calibration_Fit(enum Analog_Distance_Sensor_Index sensor, Analog_Distance_Sensor_Coefficients *coefficients);
+
 #endif /* INC_ANALOG_DISTANCE_SENSORS_H_ */
@@ -20,6 +20,7 @@
 
 // Constants
 #define BLE_UART_BUFFER_SIZE 128 ///< Buffer size for storing BLE UART data
+#define BLE_UART_PACKET_SIZE 15  ///< Size of a `!G` packet, including the prefix and the checksum
 
 // Function Declarations
 
@@ -35,6 +35,13 @@
 
 #define BARCODE_SCANNER_BUFFER_SIZE 64
 
+// Number of slots in the command dispatch table (must be a power of two)
+// At most half of the slots are used so that a lookup probes only a few slots
+#define BARCODE_SCANNER_COMMAND_TABLE_SIZE 32
+
+// Maximum number of commands that can be registered
+#define BARCODE_SCANNER_MAX_COMMANDS (BARCODE_SCANNER_COMMAND_TABLE_SIZE / 2)
+
 /**
  * @brief Carriage return character
  */
@@ -60,6 +67,19 @@
  */
 #define DEL  0x7F
 
+/**
+ * @brief Entry of the barcode command dispatch table.
+ *
+ * Hash is the precomputed Barcode_Scanner_Hash() of Command and is compared before the string itself.
+ * An entry with a NULL Command is empty.
+ */
+typedef struct
+{
+    const char *Command;
+    uint32_t Hash;
+    void (*Handler)(const char *barcode);
+} Barcode_Scanner_Command;
+
 /**
  * @brief The Barcode_Scanner_Init function initializes the EUSCI_A2 module to use UART mode.
  *
@@ -144,4 +164,84 @@ int Barcode_Scanner_Read(char *buffer_pointer, uint16_t buffer_size);
  */
 uint8_t Check_Barcode_Scanner_Command(char Barcode_Scanner_Buffer[], char *command_string);
 
+/**
+ * @brief Enables the interrupt-driven line assembler of the Barcode Scanner module.
+ *
+ * Each character received by EUSCI_A2 is handled by EUSCIA2_IRQHandler. Characters are collected
+ * into a line with the same rules as Barcode_Scanner_Read(): a backspace (BS) removes the previous
+ * character, characters beyond BARCODE_SCANNER_BUFFER_SIZE are dropped, and a carriage return (CR)
+ * completes the line. Line feed (LF) characters are ignored. The completed line is copied to a
+ * separate buffer, so the next scan can be received while the previous one is being handled.
+ *
+ * The EUSCI_A2 transmit interrupt is disabled and the receive interrupt (IRQ 18) is enabled with priority 2.
+ *
+ * @param task A pointer to the user-defined function that is called from interrupt context when a line
+ *             is completed. The string is null-terminated and remains valid until the next line is completed.
+ *             May be NULL if the line is retrieved with Barcode_Scanner_Get_Line() instead.
+ *
+ * @note Assumes that Barcode_Scanner_Init() has been called. Barcode_Scanner_Read() and
+ *       Barcode_Scanner_InChar() must not be used once the interrupt-driven reader is enabled.
+ *
+ * @return None
+ */
+void Barcode_Scanner_Async_Init(void (*task)(const char *barcode, uint16_t length));
+
+/**
+ * @brief Retrieves the most recently completed line if it has not been retrieved yet.
+ *
+ * This function does not block. If more than one line was completed since the last call,
+ * only the most recent line is returned.
+ *
+ * @param buffer_pointer Pointer to the buffer where the null-terminated line will be stored.
+ * @param buffer_size Size of the buffer, including the null terminator.
+ *
+ * @return Returns 0x01 if a new line was copied to the buffer. Otherwise, returns 0x00.
+ */
+uint8_t Barcode_Scanner_Get_Line(char *buffer_pointer, uint16_t buffer_size);
+
+/**
+ * @brief Computes the 32-bit FNV-1a hash of a string.
+ *
+ * @param string Pointer to the characters to hash.
+ * @param length Number of characters to hash.
+ *
+ * @return The 32-bit hash value.
+ */
+uint32_t Barcode_Scanner_Hash(const char *string, uint16_t length);
+
+/**
+ * @brief Registers a handler for a barcode command.
+ *
+ * The command hash is computed once here and stored in an open-addressed table, so that
+ * Barcode_Scanner_Dispatch() takes the same time regardless of how many commands are registered.
+ *
+ * @param command The null-terminated command string. It must remain valid while it is registered (e.g. a literal).
+ * @param handler A pointer to the function that is called with the scanned barcode when it matches the command.
+ *
+ * @return Returns 0x01 if the command was registered. Otherwise, returns 0x00 if the command is already
+ *         registered or BARCODE_SCANNER_MAX_COMMANDS commands have been registered.
+ */
+uint8_t Barcode_Scanner_Register_Command(const char *command, void (*handler)(const char *barcode));
+
+/**
+ * @brief Removes every registered barcode command.
+ *
+ * @return None
+ */
+void Barcode_Scanner_Clear_Commands(void);
+
+/**
+ * @brief Calls the handler of the command that matches a scanned barcode.
+ *
+ * Unlike Check_Barcode_Scanner_Command(), the barcode has to match the command exactly.
+ * The barcode is hashed once and a string comparison is only made against the entry with the same hash.
+ * This function can be called from the task passed to Barcode_Scanner_Async_Init().
+ *
+ * @param barcode The null-terminated scanned barcode.
+ * @param length Number of characters in the barcode.
+ *
+ * @return Returns 0x01 if a handler was called. Otherwise, returns 0x00.
+ */
+uint8_t Barcode_Scanner_Dispatch(const char *barcode, uint16_t length);
+
 #endif /* INC_BARCODE_SCANNER_H_ */
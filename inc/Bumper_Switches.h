@@ -33,6 +33,39 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "Clock.h"
+#include "Motor.h"
+#include "Timer32_OneShot.h"
+
+// Cycles taken by the Cortex-M4 to enter an interrupt service routine, which the DWT
+// cycle counter cannot observe from inside the handler
+#define BUMPER_EXCEPTION_ENTRY_CYCLES 12
+
+// Pins of PORT4 used by the Bumper Switches: P4.7 - P4.5, P4.3, P4.2, and P4.0.
+// When OPT3001_INTERRUPT_MODE is defined, P4.2 (OPT3001 INT) and P4.5 (OPT3001 VDD) belong to the OPT3001,
+// so BUMP_1 and BUMP_3 are not used and always read as released
+#ifdef OPT3001_INTERRUPT_MODE
+#define BUMPER_PIN_MASK 0xC9
+#else
+#define BUMPER_PIN_MASK 0xED
+#endif
+
+// Number of events that can be held by the bumper event queue (must be a power of two)
+#define BUMPER_EVENT_QUEUE_SIZE 8
+
+/**
+ * @brief A debounced change of the Bumper Switch states.
+ *
+ * State, Pressed, and Released use the 6-bit positive logic format returned by Bumper_Read().
+ * Timestamp is the value of the DWT cycle counter (MCLK cycles) at the first edge of the change.
+ */
+typedef struct
+{
+    uint8_t State;
+    uint8_t Pressed;
+    uint8_t Released;
+    uint32_t Timestamp;
+} Bumper_Event;
 
 /**
  * @brief User-defined task function for handling Bumper Switch interrupt events.
@@ -71,6 +104,102 @@ void (*Bumper_Task)(uint8_t bumper_switch_state);
  */
 void Bumper_Switches_Init(void(*task)(uint8_t));
 
+/**
+ * @brief Initialize the Bumper Switches with timer-based debouncing and an event queue.
+ *
+ * The first edge on any bumper pin disables the bumper pin interrupts, records the time, and starts
+ * TIMER32_2 as a one-shot timer. When the debounce window expires, the pins are sampled once and
+ * a Bumper_Event is queued if the stable state has changed. The edge select of each pin is then set
+ * to the opposite of its current level, so that both contacts and releases are detected, and the
+ * pin interrupts are enabled again. Each interrupt therefore does a fixed amount of work, and bounces
+ * within the window do not generate interrupts at all.
+ *
+ * The task is not called from interrupt context in this mode. Instead, the main loop calls
+ * Bumper_Process_Events() or Bumper_Get_Event().
+ *
+ * @param task A pointer to the user-defined function that Bumper_Process_Events() calls once per contact.
+ *
+ * @param debounce_us The debounce window in microseconds (e.g. 5000).
+ *
+ * @note Uses TIMER32_2 (IRQ 26) through the Timer32_OneShot driver and enables the DWT cycle counter.
+ *
+ * @return None
+ */
+void Bumper_Switches_Debounce_Init(void(*task)(uint8_t), uint32_t debounce_us);
+
+/**
+ * @brief Remove the oldest event from the bumper event queue.
+ *
+ * @param event Pointer to the structure where the event will be stored.
+ *
+ * @return 0x01 if an event was removed from the queue. Otherwise, returns 0x00 if the queue is empty.
+ */
+uint8_t Bumper_Get_Event(Bumper_Event *event);
+
+/**
+ * @brief Drain the bumper event queue and call the user-defined task once for each new contact.
+ *
+ * Events that only contain releases are discarded. This function should be called from the main loop.
+ *
+ * @return None
+ */
+void Bumper_Process_Events(void);
+
+/**
+ * @brief Return the number of events that were discarded because the event queue was full.
+ *
+ * @return The number of discarded events.
+ */
+uint32_t Bumper_Dropped_Events(void);
+
+/**
+ * @brief Enable or disable the bumper emergency stop.
+ *
+ * When enabled, PORT4_IRQHandler calls Motor_Emergency_Stop() as its first action whenever a bumper pin
+ * reports a contact (a falling edge), before any debouncing or user-defined task. The stop is latched
+ * by the Motor driver until Motor_Clear_Emergency_Stop() is called. Since PORT4 has priority 0,
+ * the stop does not depend on the main loop or on other interrupts.
+ *
+ * In debounce mode, the pin interrupts are disabled during the debounce window. A contact that starts
+ * inside the window stops the motors when the window expires, before its event is queued.
+ *
+ * The time from handler entry until the motors are stopped is measured with the DWT cycle counter
+ * on every contact and can be read with Bumper_Emergency_Stop_Max_Latency().
+ *
+ * @param enable Set to 1 to enable the emergency stop, or 0 to disable it.
+ *
+ * @note Assumes that Bumper_Switches_Init() or Bumper_Switches_Debounce_Init() and Motor_Init() have been called.
+ *
+ * @return None
+ */
+void Bumper_Enable_Emergency_Stop(uint8_t enable);
+
+/**
+ * @brief Return the worst-case interrupt-to-stop latency observed on real contacts.
+ *
+ * The value is the number of MCLK cycles from handler entry until Motor_Emergency_Stop() has returned,
+ * plus BUMPER_EXCEPTION_ENTRY_CYCLES.
+ *
+ * @return The worst-case latency in MCLK cycles, or 0 if no contact has been observed.
+ */
+uint32_t Bumper_Emergency_Stop_Max_Latency(void);
+
+/**
+ * @brief Measure the worst-case interrupt-to-stop latency by triggering the PORT4 interrupt in software.
+ *
+ * This function sets the P4.0 interrupt flag repeatedly and measures the MCLK cycles from setting the flag
+ * until the handler has stopped the motors, which includes the NVIC entry time. The emergency stop is
+ * cleared afterwards unless it was already latched. The user-defined task is not called.
+ *
+ * @param iterations The number of measurements to take.
+ *
+ * @note Interrupts must be enabled, and the motors should be idle since they are stopped during the measurement.
+ *
+ * @return The worst-case latency in MCLK cycles (divide by 48 for microseconds at 48 MHz),
+ *         or 0xFFFFFFFF if the handler did not run within 1 ms.
+ */
+uint32_t Bumper_Emergency_Stop_Self_Test(uint16_t iterations);
+
 /**
  * @brief Read the current state of the 6 Bumper Switches which have negative logic behavior.
  *
@@ -3,7 +3,11 @@
  * @brief Header file for the EUSCI_B1_I2C driver.
  *
  * This file contains the function definitions for the EUSCI_B1_I2C driver.
- * The EUSCI_B1_I2C driver uses busy-wait implementation.
+ * The EUSCI_B1_I2C driver provides a busy-wait implementation and an interrupt-driven
+ * implementation that processes a queue of transactions in the EUSCIB1_IRQHandler.
+ *
+ * @note The two implementations cannot be mixed. Once EUSCI_B1_I2C_Async_Init() has been called,
+ *       only EUSCI_B1_I2C_Submit() should be used to access the bus.
  *
  * @note This function assumes that the necessary pin configurations for I2C communication have been performed
  *       on the corresponding pins. The output from the pins will be observed using an oscilloscope.
@@ -23,6 +27,89 @@
 #include <stdint.h>
 #include "msp.h"
 
+// Maximum number of transactions that can be waiting in the queue of the interrupt-driven implementation
+#define EUSCI_B1_I2C_QUEUE_SIZE 8
+
+// Default number of EUSCI_B1_I2C_Timeout_Tick() calls before an active transaction is aborted
+#define EUSCI_B1_I2C_DEFAULT_TIMEOUT 10
+
+/**
+ * @brief Describes the kind of transfer performed by an I2C transaction.
+ */
+typedef enum
+{
+    EUSCI_B1_I2C_WRITE,         ///< Write Write_Length bytes and generate a STOP condition
+    EUSCI_B1_I2C_READ,          ///< Read Read_Length bytes and generate a STOP condition
+    EUSCI_B1_I2C_WRITE_READ     ///< Write Write_Length bytes, generate a repeated START, then read Read_Length bytes.
+                                ///< A single-byte read is preceded by a STOP and a new START instead, so that its
+                                ///< STOP condition can be generated by the byte counter
+} EUSCI_B1_I2C_Transaction_Type;
+
+/**
+ * @brief Reports the state of an I2C transaction.
+ */
+typedef enum
+{
+    EUSCI_B1_I2C_IDLE,          ///< The transaction has not been submitted
+    EUSCI_B1_I2C_PENDING,       ///< The transaction is waiting in the queue or is in progress
+    EUSCI_B1_I2C_SUCCESS,       ///< The transaction completed successfully
+    EUSCI_B1_I2C_NACK,          ///< The slave did not acknowledge its address or a data byte
+    EUSCI_B1_I2C_TIMEOUT,       ///< The transaction did not complete in time and the module was reset
+    EUSCI_B1_I2C_ARBITRATION    ///< Arbitration was lost to another master
+} EUSCI_B1_I2C_Status;
+
+/**
+ * @brief Descriptor of a transaction processed by the interrupt-driven implementation.
+ *
+ * The descriptor and its buffers are owned by the caller and must remain valid until the
+ * transaction has completed (i.e. Status is no longer EUSCI_B1_I2C_PENDING).
+ */
+typedef struct EUSCI_B1_I2C_Transaction
+{
+    EUSCI_B1_I2C_Transaction_Type Type;
+    uint8_t Slave_Address;
+    uint8_t *Write_Buffer;
+    uint16_t Write_Length;
+    uint8_t *Read_Buffer;
+    uint16_t Read_Length;
+
+    // Number of EUSCI_B1_I2C_Timeout_Tick() calls allowed once the transaction starts (0 selects the default)
+    uint16_t Timeout;
+
+    // Function called from interrupt context when the transaction completes. May be NULL.
+    void (*Callback)(struct EUSCI_B1_I2C_Transaction *transaction);
+
+    // User-defined value that is passed back through the callback
+    void *Context;
+
+    // Updated by the driver
+    volatile EUSCI_B1_I2C_Status Status;
+} EUSCI_B1_I2C_Transaction;
+
+// Maximum number of 16-bit registers that can be held by an EUSCI_B1_I2C_Register_Cache
+#define EUSCI_B1_I2C_CACHE_MAX_REGISTERS 32
+
+/**
+ * @brief Shadow copy of the 16-bit registers of a device on the EUSCI_B1 bus.
+ *
+ * Registers are addressed by a single pointer byte and transferred MSB first. Registers with an address
+ * below Register_Count are cached, and all other addresses are passed straight to the bus.
+ *
+ * The storage is owned by the caller. Volatile_Masks[n] marks the bits of register n that can be changed
+ * by the device itself (e.g. status flags or conversion results). Reads that request any volatile bit always
+ * go to the bus, while reads of the remaining bits are served from the cache once the register is valid.
+ */
+typedef struct
+{
+    uint8_t Slave_Address;
+    uint8_t Register_Count;
+    uint16_t *Values;
+    const uint16_t *Volatile_Masks;
+
+    // Bit n is set when Values[n] matches the register on the device
+    uint32_t Valid;
+} EUSCI_B1_I2C_Register_Cache;
+
 /**
  * @brief Initializes the I2C module EUSCI_B1 for communication.
  *
@@ -143,4 +230,142 @@ uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address);
  */
 void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffer, uint16_t packet_length);
 
+/**
+ * @brief Enables the interrupt-driven implementation of the EUSCI_B1_I2C driver.
+ *
+ * This function clears the transaction queue, enables the STOP, NACK, and arbitration lost interrupts
+ * of the EUSCI_B1 module, and enables the EUSCIB1 interrupt (IRQ 21) in the NVIC.
+ * The TX and RX interrupts are enabled only while a transaction needs them.
+ *
+ * @note Assumes that EUSCI_B1_I2C_Init() has been called.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Async_Init();
+
+/**
+ * @brief Adds a transaction to the queue of the interrupt-driven implementation.
+ *
+ * The function returns immediately. If the bus is idle, the transaction is started right away.
+ * Otherwise, it is started once the transactions ahead of it have completed.
+ *
+ * @param transaction Pointer to the caller-owned transaction descriptor.
+ *
+ * @return 0x01 if the transaction was queued. Otherwise, returns 0x00 if the queue is full,
+ *         the descriptor is already pending, or the lengths do not match the transaction type.
+ */
+uint8_t EUSCI_B1_I2C_Submit(EUSCI_B1_I2C_Transaction *transaction);
+
+/**
+ * @brief Checks whether the interrupt-driven implementation has any queued or active transaction.
+ *
+ * @return 0x01 if the bus is busy. Otherwise, returns 0x00.
+ */
+uint8_t EUSCI_B1_I2C_Busy();
+
+/**
+ * @brief Advances the timeout of the active transaction.
+ *
+ * This function should be called periodically (e.g. from a Timer_A1 periodic interrupt).
+ * When the active transaction runs out of ticks, the EUSCI_B1 module is reset, the transaction
+ * completes with EUSCI_B1_I2C_TIMEOUT, and the next transaction in the queue is started.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Timeout_Tick();
+
+/**
+ * @brief Initializes a register cache and marks every register as unknown.
+ *
+ * @param cache Pointer to the caller-owned cache.
+ *
+ * @param slave_address The 7-bit address of the I2C slave device.
+ *
+ * @param values Storage for Register_Count cached values.
+ *
+ * @param volatile_masks Constant table of Register_Count masks of bits that can be changed by the device.
+ *
+ * @param register_count Number of cached registers (at most EUSCI_B1_I2C_CACHE_MAX_REGISTERS).
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Cache_Init(EUSCI_B1_I2C_Register_Cache *cache, uint8_t slave_address,
+                             uint16_t *values, const uint16_t *volatile_masks, uint8_t register_count);
+
+/**
+ * @brief Writes a 16-bit register through the cache.
+ *
+ * The write is skipped if the register is valid and its non-volatile bits already hold the requested value.
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @param value The 16-bit value to write.
+ *
+ * @note Uses the busy-wait implementation and must not be called while asynchronous transactions are active.
+ *
+ * @return 0x01 if the value was written to the device. Otherwise, returns 0x00.
+ */
+uint8_t EUSCI_B1_I2C_Cache_Write(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t value);
+
+/**
+ * @brief Reads the selected bits of a 16-bit register through the cache.
+ *
+ * The bus is accessed only if the register is not valid or the mask selects a volatile bit.
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @param mask The bits of the register that are requested (0xFFFF for the whole register).
+ *
+ * @note Uses the busy-wait implementation and must not be called while asynchronous transactions are active.
+ *
+ * @return The register value with all bits outside of the mask cleared.
+ */
+uint16_t EUSCI_B1_I2C_Cache_Read(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t mask);
+
+/**
+ * @brief Changes the selected bits of a 16-bit register with a single bus write.
+ *
+ * The remaining bits are taken from the cache, so a valid register is updated without reading it back.
+ * Volatile bits are written back with their last known value.
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @param mask The bits of the register to change.
+ *
+ * @param value The new value of the selected bits.
+ *
+ * @note Uses the busy-wait implementation and must not be called while asynchronous transactions are active.
+ *
+ * @return 0x01 if the value was written to the device. Otherwise, returns 0x00.
+ */
+uint8_t EUSCI_B1_I2C_Cache_Modify(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t mask, uint16_t value);
+
+/**
+ * @brief Records a value that was transferred to or from a register outside of the cache (e.g. asynchronously).
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @param value The value currently held by the device.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Cache_Update(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t value);
+
+/**
+ * @brief Marks every register as unknown so that the next access goes to the bus (e.g. after a device reset).
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @return None
+ */
+void EUSCI_B1_I2C_Cache_Invalidate(EUSCI_B1_I2C_Register_Cache *cache);
+
 #endif /* INC_EUSCI_B1_I2C_H_ */
@@ -6,6 +6,10 @@
  * gyroscope data received over BLE. It includes utilities for extracting
  * floating-point values from BLE packets and performing packet validation.
  *
+ * The gyroscope values are converted once, when the packet is parsed, to Q16.16 fixed point
+ * (signed 32-bit integers with 16 fractional bits), so that the code that acts on each packet
+ * only needs integer arithmetic.
+ *
  * @author Nainika Saha
  */
 
@@ -15,6 +19,25 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define GYRO_PACKET_SIZE 15 ///< Size of a gyroscope packet: `!G`, three floats and the checksum
+
+#define GYRO_Q16_SHIFT 16                   ///< Number of fractional bits of the Q16.16 gyroscope values
+#define GYRO_Q16_ONE (1 << GYRO_Q16_SHIFT)  ///< 1.0 in Q16.16
+#define GYRO_Q16_MAX 0x7FFFFFFF             ///< Largest magnitude of a Q16.16 value (about 32768.0)
+
+// Q16.16 constant from a value in thousandths, e.g. GYRO_Q16_FROM_MILLI(200) for 0.2
+#define GYRO_Q16_FROM_MILLI(milli) ((int32_t)(((int64_t)(milli) * GYRO_Q16_ONE) / 1000))
+
+/**
+ * @brief Gyroscope values of a packet in Q16.16 fixed point.
+ */
+typedef struct
+{
+    int32_t X; ///< X-axis value
+    int32_t Y; ///< Y-axis value
+    int32_t Z; ///< Z-axis value
+} Gyro_Sample;
+
 // Function Declarations
 
 /**
@@ -24,23 +47,41 @@
  * and handles it appropriately.
  *
  * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
+ * @return true if the packet was valid and parsed, false otherwise.
+ */
+bool ParseBLEPacket(uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Parses a BLE packet and returns its gyroscope values in Q16.16.
+ *
+ * Validates the packet, converts the X, Y and Z values to Q16.16 with ExtractQ16()
+ * and prints them.
+ *
+ * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
+ * @param sample Pointer to store the gyroscope values. Left unchanged if the packet is invalid.
+ * @return true if the packet was valid and parsed, false otherwise.
  */
-void ParseBLEPacket(uint8_t *buffer);
+bool ParseGyroPacket(uint8_t *buffer, uint16_t length, Gyro_Sample *sample);
 
 /**
  * @brief Validates the structure of a BLE packet.
  *
- * Checks whether the packet has the correct prefix, size, and structure.
+ * Checks whether the packet has the correct size, prefix, and checksum.
+ * No byte beyond the given length is read.
  *
  * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
  * @return true if the packet structure is valid, false otherwise.
  */
-bool ValidateBLEPacket(uint8_t *buffer);
+bool ValidateBLEPacket(uint8_t *buffer, uint16_t length);
 
 /**
  * @brief Validates the CRC (checksum) of a BLE packet.
  *
  * Computes the checksum of the packet and compares it with the provided CRC.
+ * The buffer must hold at least GYRO_PACKET_SIZE bytes.
  *
  * @param buffer Pointer to the BLE packet buffer.
  * @return true if the CRC is valid, false otherwise.
@@ -51,12 +92,25 @@ bool ValidateCRC(uint8_t *buffer);
  * @brief Extracts a floating-point value from a BLE packet.
  *
  * Interprets four consecutive bytes from the specified offset in the BLE packet
- * as a 32-bit floating-point value.
+ * as a 32-bit floating-point value. The buffer must hold at least GYRO_PACKET_SIZE bytes.
  *
  * @param buffer Pointer to the BLE packet buffer.
  * @param offset Offset in the buffer where the float starts.
- * @return The extracted float value.
+ * @return The extracted float value, or 0 if the float would extend past the packet.
  */
 float ExtractFloat(uint8_t *buffer, uint8_t offset);
 
+/**
+ * @brief Extracts a floating-point value from a BLE packet as Q16.16 fixed point.
+ *
+ * Decodes the IEEE 754 single-precision value at the specified offset with integer operations
+ * only. The result is rounded toward zero and saturated to +/-GYRO_Q16_MAX. NaN is returned as 0.
+ * The buffer must hold at least GYRO_PACKET_SIZE bytes.
+ *
+ * @param buffer Pointer to the BLE packet buffer.
+ * @param offset Offset in the buffer where the float starts.
+ * @return The extracted value in Q16.16, or 0 if the float would extend past the packet.
+ */
+int32_t ExtractQ16(uint8_t *buffer, uint8_t offset);
+
 #endif // GYRO_PARSER_H
@@ -0,0 +1,56 @@
+/**
+ * @file HAL.h
+ * @brief Thin hardware abstraction layer for the register accesses that need peripheral behavior.
+ *
+ * The drivers access the MSP432P401R registers directly through msp.h. Most of these accesses only
+ * read or write configuration bits and work unchanged against the simulated register file of the
+ * host backend. The few accesses that depend on the peripheral doing something (waiting for a flag
+ * to be set by the hardware, or reading and writing the eUSCI data buffers) go through the macros
+ * in this file instead:
+ *
+ *  - MSP432 backend (default): the macros expand to the plain register accesses, so the generated
+ *    code is identical to accessing the registers directly.
+ *
+ *  - Host backend (HAL_HOST defined): the macros call the host simulation in host/HAL_Host.c, which
+ *    moves bytes between the simulated eUSCI buffers and FIFOs, completes ADC conversions and I2C
+ *    START/STOP conditions, and advances the simulated cycle counter while a driver is waiting.
+ *
+ * @author Aaron Nanas
+ */
+
+#ifndef INC_HAL_H_
+#define INC_HAL_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+#ifdef HAL_HOST
+
+#include "HAL_Host.h"
+
+/**
+ * @brief Waits while the condition is true, letting the simulated peripherals run in between.
+ */
+#define HAL_WAIT_WHILE(condition)               do { HAL_Host_Poll(); } while (condition)
+
+/**
+ * @brief Reads the Receive Buffer (RXBUF) of an eUSCI module, clearing its UCRXIFG flag.
+ */
+#define HAL_EUSCI_READ_RXBUF(module)            HAL_Host_Read_RXBUF((module))
+
+/**
+ * @brief Writes a byte to the Transmit Buffer (TXBUF) of an eUSCI module.
+ */
+#define HAL_EUSCI_WRITE_TXBUF(module, data)     HAL_Host_Write_TXBUF((module), (data))
+
+#else
+
+#define HAL_WAIT_WHILE(condition)               while (condition)
+
+#define HAL_EUSCI_READ_RXBUF(module)            ((module)->RXBUF)
+
+#define HAL_EUSCI_WRITE_TXBUF(module, data)     ((module)->TXBUF = (data))
+
+#endif /* HAL_HOST */
+
+#endif /* INC_HAL_H_ */
@@ -0,0 +1,123 @@
+/**
+ * @file Heading_Fusion.h
+ * @brief Header file for the Heading_Fusion driver.
+ *
+ * This file contains the function definitions for the Heading_Fusion driver.
+ * The Heading_Fusion driver combines the Z-axis angular rate streamed by the phone over BLE
+ * with the yaw rate derived from the wheel odometry to estimate the actual heading of the platform.
+ *
+ * A complementary filter is applied to the heading increments at the control rate:
+ *  - While the wheels agree with the gyroscope, the increment is a weighted mix of both,
+ *    and the gyroscope bias is learned while the platform is not turning
+ *  - When the two rates disagree by more than HEADING_FUSION_SLIP_THRESHOLD for several updates,
+ *    the wheels are considered to be slipping and only the gyroscope is used
+ *  - When no gyroscope sample has been received recently, only the wheels are used
+ *
+ * All computations use integer arithmetic. Rates are in milliradians per second and headings are
+ * binary angles (2^32 = 360 degrees), as in the Odometry driver.
+ *
+ * @note The phone is assumed to lie flat on the platform, so that a counterclockwise rotation
+ *       of the platform produces a positive Z rate.
+ *
+ * @author Nainika Saha
+ */
+
+#ifndef INC_HEADING_FUSION_H_
+#define INC_HEADING_FUSION_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "../inc/Odometry.h"
+
+// Weight of the wheel increment when the wheels do not slip (1 / 2^shift)
+#define HEADING_FUSION_WHEEL_WEIGHT_SHIFT 2
+
+// Difference between the gyroscope and wheel yaw rates that indicates slip (milliradians per second)
+#define HEADING_FUSION_SLIP_THRESHOLD 300
+
+// Number of consecutive updates above or below the threshold before the slip state changes
+#define HEADING_FUSION_SLIP_COUNT 3
+
+// Largest wheel yaw rate at which the platform is considered to be not turning (milliradians per second)
+#define HEADING_FUSION_STILL_THRESHOLD 20
+
+// Bias learning rate while the platform is not turning (1 / 2^shift per update)
+#define HEADING_FUSION_BIAS_SHIFT 6
+
+// Full-scale range of the phone gyroscope (2000 degrees per second, in milliradians per second)
+#define HEADING_FUSION_MAX_GYRO_RATE 34907
+
+// Binary angle units per milliradian (2^32 / (2 * pi * 1000))
+#define HEADING_FUSION_BINARY_ANGLE_PER_MRAD 683565
+
+/**
+ * @brief Fused heading estimate.
+ */
+typedef struct
+{
+    // Estimated heading as a binary angle
+    uint32_t Heading;
+
+    // Fused yaw rate, gyroscope yaw rate after bias correction, and wheel yaw rate (milliradians per second)
+    int32_t Yaw_Rate;
+    int32_t Gyro_Rate;
+    int32_t Wheel_Rate;
+
+    // Estimated gyroscope bias (milliradians per second)
+    int32_t Gyro_Bias;
+
+    // 0x01 while the wheels are slipping, 0x00 otherwise
+    uint8_t Slip;
+
+    // 0x01 if a recent gyroscope sample was used, 0x00 if only the wheels were used
+    uint8_t Gyro_Valid;
+
+    // Number of updates during which slip was detected
+    uint32_t Slip_Updates;
+} Heading_Fusion_State;
+
+/**
+ * @brief Initialize the heading estimate.
+ *
+ * The current odometry heading is taken as the starting heading.
+ *
+ * @param update_rate_hz The rate at which Heading_Fusion_Update() will be called (Hz).
+ *
+ * @note Assumes that Odometry_Init() has been called.
+ *
+ * @return None
+ */
+void Heading_Fusion_Init(uint16_t update_rate_hz);
+
+/**
+ * @brief Provide the latest Z-axis angular rate received from the phone.
+ *
+ * The sample is used by the following updates until it becomes older than a quarter of a second.
+ *
+ * @param z_rate The Z-axis angular rate (milliradians per second). Values beyond the full-scale range
+ *               of the gyroscope are limited to +/-HEADING_FUSION_MAX_GYRO_RATE.
+ *
+ * @return None
+ */
+void Heading_Fusion_Set_Gyro_Rate(int32_t z_rate);
+
+/**
+ * @brief Advance the heading estimate by one control period.
+ *
+ * @note Should be called at the rate passed to Heading_Fusion_Init(), right after Odometry_Update().
+ *
+ * @return None
+ */
+void Heading_Fusion_Update(void);
+
+/**
+ * @brief Get a copy of the latest heading estimate.
+ *
+ * @param state Pointer to store the estimate.
+ *
+ * @return None
+ */
+void Heading_Fusion_Get(Heading_Fusion_State *state);
+
+#endif /* INC_HEADING_FUSION_H_ */
@@ -0,0 +1,125 @@
+/**
+ * @file Latency.h
+ * @brief Header file for the Latency driver.
+ *
+ * This file contains the function definitions for the Latency driver.
+ * The Latency driver measures the end-to-end delay from the first byte of a BLE packet received
+ * on P9.6 (EUSCI_A3) to the update of the PWM duty cycles of the motors on Timer_A0, and collects
+ * the measurements in a histogram that can be printed over EUSCI_A0.
+ *
+ * Three points of the pipeline are timestamped with the DWT cycle counter:
+ *  - BLE_UART_InString() marks the `!` that starts a packet as soon as it is read from RXBUF
+ *  - The application marks the packet as valid once it has been parsed
+ *  - The Motor driver marks the next update of the CCR[3] and CCR[4] registers, either from the
+ *    main loop or from the control loop, which completes the measurement
+ *
+ * If another packet becomes valid before the previous one has reached the motors, the previous
+ * packet is counted as dropped and only the newer packet is measured.
+ *
+ * @note The receive timestamp is taken when the byte is read. Any time that the byte spends in
+ *       RXBUF while the main loop is busy is therefore not included.
+ *
+ * @author Nainika Saha
+ */
+
+#ifndef INC_LATENCY_H_
+#define INC_LATENCY_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/EUSCI_A0_UART.h"
+
+// Width of each histogram bucket in microseconds
+#define LATENCY_BUCKET_US 1000
+
+// Number of histogram buckets (the last bucket also counts every longer latency)
+#define LATENCY_BUCKET_COUNT 64
+
+/**
+ * @brief Histogram of the packet-to-actuation latencies.
+ */
+typedef struct
+{
+    // Number of measurements in each bucket of LATENCY_BUCKET_US microseconds
+    uint32_t Buckets[LATENCY_BUCKET_COUNT];
+
+    // Number of measurements
+    uint32_t Count;
+
+    // Valid packets that were superseded before reaching the motors
+    uint32_t Dropped;
+
+    // Shortest, longest and total latency (microseconds)
+    uint32_t Min_us;
+    uint32_t Max_us;
+    uint64_t Sum_us;
+} Latency_Histogram;
+
+/**
+ * @brief Initialize the latency measurement with an empty histogram.
+ *
+ * Enables the DWT cycle counter. The marks have no effect until this function has been called.
+ *
+ * @return None
+ */
+void Latency_Init(void);
+
+/**
+ * @brief Clear the histogram and discard the packet being measured.
+ *
+ * @return None
+ */
+void Latency_Reset(void);
+
+/**
+ * @brief Timestamp the first byte of a packet.
+ *
+ * Called by BLE_UART_InString() for every `!` that starts a packet.
+ *
+ * @return None
+ */
+void Latency_Mark_Receive(void);
+
+/**
+ * @brief Start measuring the packet whose first byte was last marked.
+ *
+ * Should be called by the application once the packet has passed validation.
+ *
+ * @return None
+ */
+void Latency_Mark_Valid(void);
+
+/**
+ * @brief Complete the measurement of the valid packet, if there is one.
+ *
+ * Called by the Motor driver right after the duty cycles have been written to Timer_A0.
+ * May be called from interrupt handlers.
+ *
+ * @return None
+ */
+void Latency_Mark_Actuation(void);
+
+/**
+ * @brief Get a copy of the histogram.
+ *
+ * @param histogram Pointer to store the histogram.
+ *
+ * @return None
+ */
+void Latency_Get_Histogram(Latency_Histogram *histogram);
+
+/**
+ * @brief Print the histogram over EUSCI_A0.
+ *
+ * Prints the number of measurements, the number of dropped packets, the minimum, mean and
+ * maximum latency, and one line for each bucket that is not empty.
+ *
+ * @note Assumes that EUSCI_A0_UART_Init() or EUSCI_A0_UART_Init_Printf() has been called.
+ *
+ * @return None
+ */
+void Latency_Print_Histogram(void);
+
+#endif /* INC_LATENCY_H_ */
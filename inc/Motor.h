@@ -17,6 +17,7 @@
 #include "msp.h"
 #include "../inc/CortexM.h"
 #include "../inc/Timer_A0_PWM.h"
+#include "../inc/Latency.h"
 
 /**
  * @brief Initializes the DC motors.
@@ -97,4 +98,33 @@ void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle);
  */
 void Motor_Stop();
 
+/**
+ * @brief Stop the motors immediately and latch the stop until it is cleared.
+ *
+ * This function clears the motor enable pins (P3.6 and P3.7) and forces the Timer A0 PWM outputs low
+ * with a fixed, short sequence of register writes so that it can be called directly from an interrupt
+ * service routine. While the stop is latched, Motor_Forward(), Motor_Backward(), Motor_Left(), and
+ * Motor_Right() have no effect.
+ *
+ * @return None
+ */
+void Motor_Emergency_Stop();
+
+/**
+ * @brief Release a latched emergency stop.
+ *
+ * The duty cycle of both motors is set to 0% and the PWM outputs are returned to Timer A0.
+ * The motors stay disabled until the next call to Motor_Forward(), Motor_Backward(), Motor_Left(), or Motor_Right().
+ *
+ * @return None
+ */
+void Motor_Clear_Emergency_Stop();
+
+/**
+ * @brief Check whether an emergency stop is latched.
+ *
+ * @return 0x01 if an emergency stop is latched. Otherwise, returns 0x00.
+ */
+uint8_t Motor_Is_Emergency_Stopped();
+
 #endif /* INC_MOTOR_H_ */
@@ -20,7 +20,9 @@
  *  - OPT3001 Pin 5 (INT)       <-->  MSP432 LaunchPad Pin P4.2
  *  - OPT3001 Pin 6 (SDA)       <-->  MSP432 LaunchPad Pin P6.4
  *
- * @note Do not use with bumper sensors to avoid any pin conflicts.
+ * @note P4.2 and P4.5 are also used by BUMP_1 and BUMP_3 of the bumper sensors. When OPT3001_INTERRUPT_MODE
+ *       is defined, the Bumper_Switches driver leaves these pins to the OPT3001 and its PORT4_IRQHandler
+ *       passes the P4.2 edges to OPT3001_Interrupt_Handler().
  *
  * @note For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -41,6 +43,12 @@
 
 #define OPT3001_ADDRESS 0x44
 
+// Smallest distance between the current level and each edge of the window mode window (1 lux, in units of 0.01 lux)
+#define OPT3001_MIN_HYSTERESIS_CENTILUX 100
+
+// Number of times a failed asynchronous register read is retried before the driver reports an error
+#define OPT3001_MAX_RETRIES 3
+
 /**
  * @brief The struct is used to define the individual bit fields within RawData
  * when it is being interpreted as a struct value
@@ -98,4 +106,148 @@ void OPT3001_Init();
  */
 OPT3001_Result OPT3001_Read_Light(void);
 
+/**
+ * @brief Switches the OPT3001 to end-of-conversion interrupt mode.
+ *
+ * This function writes 0xC000 to the Low-Limit register, which makes the INT pin assert at the end of every
+ * conversion. It then enables the interrupt-driven EUSCI_B1_I2C implementation and a falling-edge interrupt on P4.2.
+ * Every interrupt queues an asynchronous read of the Configuration register (which clears the latched INT pin)
+ * and the Result register. The result is cached together with a timestamp, so no I2C traffic occurs between conversions.
+ *
+ * After this function returns, OPT3001_Read_Light() returns the cached result instead of accessing the bus.
+ *
+ * @note Assumes that OPT3001_Init() has been called.
+ *
+ * @note EUSCI_B1_I2C_Timeout_Tick() should be called periodically so that a stuck bus is recovered.
+ *
+ * @note When OPT3001_INTERRUPT_MODE is defined, PORT4_IRQHandler in the Bumper_Switches driver passes
+ *       the P4.2 edges to this driver. Otherwise, OPT3001_Interrupt_Handler() must be called from the
+ *       PORT4 interrupt service routine.
+ *
+ * @note The priority level of the PORT4 interrupt (IRQ 38) is not changed. Bumper_Switches_Init() sets it
+ *       to 0 for the emergency stop, and the OPT3001 reads are serviced at the same level.
+ *
+ * @note A failed register read is retried up to OPT3001_MAX_RETRIES times. See OPT3001_Get_Error_State().
+ *
+ * @return None
+ */
+void OPT3001_Enable_Conversion_Interrupt(void);
+
+/**
+ * @brief Selects the conversion time of the OPT3001.
+ *
+ * The other configuration fields are taken from the driver's shadow copy of the Configuration register,
+ * so the change costs a single I2C write, or none if the conversion time is already selected.
+ *
+ * @param long_conversion Set to 1 for 800 ms conversions (lower noise), or 0 for 100 ms conversions.
+ *
+ * @note Assumes that OPT3001_Init() has been called.
+ *
+ * @note While an interrupt mode is active, the busy-wait EUSCI_B1_I2C functions must not be used, so the write
+ *       is queued with EUSCI_B1_I2C_Submit() instead. The change is rejected if the previous change of the
+ *       Configuration register is still pending, or if the register has not been read since the last error.
+ *
+ * @return 0x01 if the conversion time is selected or the write was queued. Otherwise, returns 0x00.
+ */
+uint8_t OPT3001_Set_Conversion_Time(uint8_t long_conversion);
+
+/**
+ * @brief Selects the mode of conversion operation of the OPT3001.
+ *
+ * The other configuration fields are taken from the driver's shadow copy of the Configuration register,
+ * so the change costs a single I2C write, or none if the mode is already selected.
+ *
+ * @param mode 0 for shutdown, 1 for single-shot, or 2 and 3 for continuous conversions.
+ *
+ * @note Assumes that OPT3001_Init() has been called.
+ *
+ * @note The device returns to shutdown after a single-shot conversion. Selecting single-shot mode always
+ *       writes the register, so call this function again to start each single-shot conversion.
+ *
+ * @note While an interrupt mode is active, the write is queued with EUSCI_B1_I2C_Submit() and rejected in the
+ *       same cases as OPT3001_Set_Conversion_Time().
+ *
+ * @return 0x01 if the mode is selected or the write was queued. Otherwise, returns 0x00.
+ */
+uint8_t OPT3001_Set_Conversion_Mode(uint8_t mode);
+
+/**
+ * @brief Switches the OPT3001 to latched window interrupt mode with automatic hysteresis.
+ *
+ * This function measures the current level and programs the Low-Limit and High-Limit registers with a window
+ * of +/- hysteresis_percent around it (at least OPT3001_MIN_HYSTERESIS_CENTILUX on each side). The INT pin only
+ * asserts when a conversion falls outside the window. Each interrupt reads the new result, moves the window
+ * around it with asynchronous register writes, and calls the user-defined task. While the level stays inside
+ * the window, no interrupts occur and no I2C traffic is generated.
+ *
+ * @param hysteresis_percent Half-width of the window relative to the current level (in percent).
+ *
+ * @param task A pointer to the user-defined function that is called from interrupt context with the new level
+ *             in units of 0.01 lux. May be NULL.
+ *
+ * @note Assumes that OPT3001_Init() has been called.
+ *
+ * @note The same PORT4_IRQHandler requirements as OPT3001_Enable_Conversion_Interrupt() apply.
+ *
+ * @return None
+ */
+void OPT3001_Enable_Window_Interrupt(uint8_t hysteresis_percent, void(*task)(uint32_t centilux));
+
+/**
+ * @brief Converts a result into a level in units of 0.01 lux using integer arithmetic.
+ *
+ * The level is computed as Result * 2^Exponent, which is exact and fits in 32 bits (at most 8,386,560).
+ *
+ * @param result An OPT3001_Result structure obtained from the sensor.
+ *
+ * @return The level in units of 0.01 lux.
+ */
+uint32_t OPT3001_Convert_Centilux(OPT3001_Result result);
+
+/**
+ * @brief Returns the most recent level cached by the interrupt modes.
+ *
+ * @return The level in units of 0.01 lux.
+ */
+uint32_t OPT3001_Get_Latest_Centilux(void);
+
+/**
+ * @brief Handles a falling edge of the OPT3001 INT pin (P4.2).
+ *
+ * Clears the P4.2 interrupt flag and queues the asynchronous register reads. If the previous reads
+ * have not completed yet, the edge is skipped, and the reads are restarted once they complete
+ * if the INT pin is still asserted.
+ *
+ * Calling this function from the application leaves the error state and restarts the reads.
+ *
+ * @return None
+ */
+void OPT3001_Interrupt_Handler(void);
+
+/**
+ * @brief Reports whether the asynchronous register reads have stopped after repeated failures.
+ *
+ * A read that ends with a NACK, a timeout, or a lost arbitration is retried up to OPT3001_MAX_RETRIES
+ * times. After that, the INT pin stays latched and no more interrupts occur until
+ * OPT3001_Interrupt_Handler() is called.
+ *
+ * @param error_count Pointer to store the total number of failed reads since the interrupt mode was enabled.
+ *                    May be NULL.
+ *
+ * @return 1 if the reads have stopped, or 0 otherwise.
+ */
+uint8_t OPT3001_Get_Error_State(uint32_t *error_count);
+
+/**
+ * @brief Returns the most recent result cached by the conversion-ready interrupt mode.
+ *
+ * @param result Pointer to store the cached result. May be NULL.
+ *
+ * @param timestamp Pointer to store the DWT cycle counter value (MCLK cycles) when the conversion completed. May be NULL.
+ *
+ * @return The number of conversions cached since OPT3001_Enable_Conversion_Interrupt() was called.
+ *         A caller can compare this value with the previous one to detect a new result.
+ */
+uint32_t OPT3001_Get_Latest(OPT3001_Result *result, uint32_t *timestamp);
+
 #endif /* INC_OPT3001_H_ */
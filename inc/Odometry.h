@@ -0,0 +1,136 @@
+/**
+ * @file Odometry.h
+ * @brief Header file for the Odometry driver.
+ *
+ * This file contains the function definitions for the Odometry driver.
+ * The Odometry driver integrates the wheel steps measured by the Tachometer driver into the
+ * position (x, y), heading (theta), and velocity of a differential-drive robot.
+ *
+ * All computations use integer arithmetic:
+ *  - Positions are stored in units of 1/65536 micrometers and reported in micrometers
+ *  - Headings are binary angles, where 2^32 corresponds to one full turn (theta wraps naturally)
+ *  - Sine and cosine are interpolated from a 256-entry Q15 table
+ *
+ * The heading is 0 along the positive x axis and increases counterclockwise (turning left).
+ *
+ * @note Odometry_Update() should be called at a fixed rate (e.g. 100 Hz from a Timer_A1 periodic interrupt).
+ *
+ * @author Aaron Nanas
+ *
+ */
+
+#ifndef INC_ODOMETRY_H_
+#define INC_ODOMETRY_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Tachometer.h"
+
+// Wheel circumference (360 steps per ~220 mm circumference)
+#define ODOMETRY_WHEEL_CIRCUMFERENCE_UM 220000
+
+// Number of tachometer steps per wheel revolution
+#define ODOMETRY_STEPS_PER_REVOLUTION 360
+
+// Distance between the centers of the two wheels
+#define ODOMETRY_WHEEL_BASE_UM 140000
+
+// Distance traveled by a wheel per step in units of 1/65536 micrometers (220000 * 65536 / 360)
+#define ODOMETRY_UM_PER_STEP_Q16 40049778
+
+// Change of heading per step of difference between the wheels as a binary angle
+// (220000 / 360) / 140000 radians * (2^32 / (2 * pi)) binary angle units per radian
+#define ODOMETRY_BINARY_ANGLE_PER_STEP 2983801
+
+// Number of Timer A3 ticks per second (SMCLK = 12 MHz)
+#define ODOMETRY_TICKS_PER_SECOND 12000000
+
+/**
+ * @brief Pose and velocity of the robot.
+ */
+typedef struct
+{
+    // Position relative to the starting point (micrometers)
+    int32_t X;
+    int32_t Y;
+
+    // Heading as a binary angle (2^32 = 360 degrees, degrees = Theta * 360 / 2^32)
+    uint32_t Theta;
+
+    // Forward velocity of the center of the robot (millimeters per second)
+    int32_t Linear_Velocity;
+
+    // Rate of change of the heading (milliradians per second, positive counterclockwise)
+    int32_t Angular_Velocity;
+
+    // 32-bit Timer A3 time of the tachometer snapshot used for the last update (units of 83.3 ns)
+    uint32_t Time;
+} Odometry_Pose;
+
+/**
+ * @brief Initialize the odometry at the origin with a heading of 0.
+ *
+ * The current tachometer step counts are taken as the starting point.
+ *
+ * @note Assumes that Tachometer_Init() has been called.
+ *
+ * @return None
+ */
+void Odometry_Init(void);
+
+/**
+ * @brief Set the pose of the robot.
+ *
+ * @param x The x position (micrometers).
+ *
+ * @param y The y position (micrometers).
+ *
+ * @param theta The heading as a binary angle.
+ *
+ * @return None
+ */
+void Odometry_Reset(int32_t x, int32_t y, uint32_t theta);
+
+/**
+ * @brief Integrate the wheel steps since the previous update into the pose.
+ *
+ * The distance traveled by each wheel is taken from a consistent tachometer snapshot. The center of the robot
+ * is assumed to move along the heading halfway between the old and the new heading (second-order integration).
+ * The velocities are computed from the average tachometer periods of both wheels.
+ *
+ * @note This function may be called from a periodic interrupt, but not from the Timer A3 capture interrupts.
+ *
+ * @return None
+ */
+void Odometry_Update(void);
+
+/**
+ * @brief Get a consistent copy of the latest pose.
+ *
+ * The copy is taken without disabling interrupts, so it is cheap enough for the control loop.
+ *
+ * @param pose Pointer to store the pose.
+ *
+ * @return None
+ */
+void Odometry_Get_Pose(Odometry_Pose *pose);
+
+/**
+ * @brief Compute the sine of a binary angle.
+ *
+ * @param theta The angle as a binary angle (2^32 = 360 degrees).
+ *
+ * @return The sine in Q15 format (-32767 to 32767).
+ */
+int16_t Odometry_Sin(uint32_t theta);
+
+/**
+ * @brief Compute the cosine of a binary angle.
+ *
+ * @param theta The angle as a binary angle (2^32 = 360 degrees).
+ *
+ * @return The cosine in Q15 format (-32767 to 32767).
+ */
+int16_t Odometry_Cos(uint32_t theta);
+
+#endif /* INC_ODOMETRY_H_ */
@@ -40,6 +40,32 @@
 #include <stdint.h>
 #include "msp.h"
 #include "Clock.h"
+#include "Timer32_OneShot.h"
+
+// Time (in microseconds) that the sensor outputs are driven high to charge the capacitors
+#define REFLECTANCE_SENSOR_CHARGE_TIME_US 10
+
+// Number of channels in the 8-Channel QTRX Sensor Array module
+#define REFLECTANCE_SENSOR_CHANNELS 8
+
+// Full-scale value of a normalized (grey-scale) reflectance reading
+#define REFLECTANCE_SENSOR_GREY_MAX 1000
+
+// Normalized readings below this value are treated as white when computing the analog line position
+#define REFLECTANCE_SENSOR_GREY_NOISE 50
+
+/**
+ * @brief Line position and validity flag for one 8-bit reflectance sensor reading.
+ *
+ * Position is in 0.1mm relative to the center of the line. Valid is 1 if at least one sensor detects the line.
+ * The struct occupies a single 32-bit word so that an entry can be fetched with one load.
+ */
+typedef struct
+{
+    int16_t Position;
+    uint8_t Valid;
+    uint8_t Reserved;
+} Reflectance_Sensor_Line;
 
 /**
  * @brief Initializes the 8-Channel QTRX Sensor Array module.
@@ -96,11 +122,44 @@ void Reflectance_Sensor_Start();
  */
 uint8_t Reflectance_Sensor_End();
 
+/**
+ * @brief Starts a non-blocking read of the eight sensors from the 8-Channel QTRX Sensor Array module.
+ *
+ * This function performs the same sequence as Reflectance_Sensor_Read(), but each waiting period is
+ * handled by a one-shot Timer32 interrupt instead of a busy-wait delay:
+ *  1. Turns on the 8 IR LEDs and drives the sensor pins high (in the caller's context).
+ *  2. After 10 microseconds, makes the sensor pins input (in the Timer32 interrupt).
+ *  3. After the specified time, reads the sensors and turns off the IR LEDs (in the Timer32 interrupt).
+ *
+ * The function returns immediately. When the read completes, the result is stored and the user-defined
+ * task (if any) is called from interrupt context with the 8-bit reflectance sensor data.
+ *
+ * @param time The time to wait in microseconds before reading the sensors.
+ *
+ * @param task A pointer to the user-defined function to be called with the result. May be NULL.
+ *
+ * @note Assumes that Reflectance_Sensor_Init() and Timer32_OneShot_Init() have been called.
+ *
+ * @return 0x01 if the read was started. Otherwise, returns 0x00 if a read is already in progress.
+ */
+uint8_t Reflectance_Sensor_Read_Async(uint32_t time, void(*task)(uint8_t reflectance_value));
+
+/**
+ * @brief Checks whether the most recent non-blocking read has completed.
+ *
+ * @param reflectance_value Pointer to store the 8-bit reflectance sensor data if the read has completed. May be NULL.
+ *
+ * @return 0x01 if a new result is available since the last call. Otherwise, returns 0x00.
+ */
+uint8_t Reflectance_Sensor_Async_Result(uint8_t *reflectance_value);
+
 /**
  * @brief Performs sensor integration for the 8-Channel QTRX Sensor Array module.
  *
  * This function takes an 8-bit sensor reading and calculates the position
  * in 0.1mm relative to the center of the line based on predefined weight values.
+ * The result is read from a 256-entry table that is generated at compile time, so the
+ * function takes constant time.
  *
  * @param data 8-bit result from the line sensor.
  *
@@ -108,4 +167,87 @@ uint8_t Reflectance_Sensor_End();
  */
 int32_t Reflectance_Sensor_Position(uint8_t data);
 
+/**
+ * @brief Looks up the line position and validity flag for an 8-bit sensor reading.
+ *
+ * Same as Reflectance_Sensor_Position(), but also reports whether a line was detected,
+ * so the caller does not have to compare against the default position value.
+ *
+ * @param data 8-bit result from the line sensor.
+ *
+ * @return Reflectance_Sensor_Line entry containing the position in 0.1mm and the validity flag.
+ */
+Reflectance_Sensor_Line Reflectance_Sensor_Line_Lookup(uint8_t data);
+
+/**
+ * @brief Measures the discharge time of each of the eight sensors.
+ *
+ * This function charges the sensor capacitors, releases the sensor pins, and then repeatedly samples P7
+ * while the capacitors discharge. The time at which each pin reads low is recorded using the DWT cycle counter.
+ * The function returns as soon as every pin has read low, or when the timeout expires.
+ * A dark surface reflects less light and results in a longer discharge time.
+ *
+ * @param discharge_time Array of REFLECTANCE_SENSOR_CHANNELS elements to store the discharge time of each sensor
+ *                       (in microseconds). Element 0 corresponds to P7.0. Sensors that have not discharged
+ *                       before the timeout are reported as the timeout value.
+ *
+ * @param timeout The maximum time to wait for the sensors to discharge in microseconds.
+ *
+ * @note Assumes that Reflectance_Sensor_Init() has been called.
+ *
+ * @return None
+ */
+void Reflectance_Sensor_Read_Discharge(uint16_t discharge_time[], uint16_t timeout);
+
+/**
+ * @brief Clears the white and black calibration of the eight sensors.
+ *
+ * @return None
+ */
+void Reflectance_Sensor_Calibration_Reset();
+
+/**
+ * @brief Updates the white and black calibration of the eight sensors with a new set of discharge times.
+ *
+ * The shortest and longest discharge times seen by each sensor are used as its white and black reference.
+ * Call this function repeatedly while sweeping the sensor array across the line and the background.
+ *
+ * @param discharge_time Array of REFLECTANCE_SENSOR_CHANNELS discharge times obtained from Reflectance_Sensor_Read_Discharge().
+ *
+ * @return None
+ */
+void Reflectance_Sensor_Calibration_Update(const uint16_t discharge_time[]);
+
+/**
+ * @brief Converts the discharge times of the eight sensors into grey-scale values.
+ *
+ * Each discharge time is scaled between the white and black reference of its sensor, using a
+ * precomputed reciprocal so that no division is performed.
+ *
+ * @param discharge_time Array of REFLECTANCE_SENSOR_CHANNELS discharge times obtained from Reflectance_Sensor_Read_Discharge().
+ *
+ * @param grey Array of REFLECTANCE_SENSOR_CHANNELS elements to store the grey-scale values,
+ *             from 0 (white) to REFLECTANCE_SENSOR_GREY_MAX (black).
+ *
+ * @note Sensors that have not been calibrated are reported as 0.
+ *
+ * @return None
+ */
+void Reflectance_Sensor_Normalize(const uint16_t discharge_time[], uint16_t grey[]);
+
+/**
+ * @brief Calculates the position of the line from eight grey-scale values.
+ *
+ * The position is the grey-weighted centroid of the sensor weights used by Reflectance_Sensor_Position(),
+ * which gives a resolution finer than the sensor spacing.
+ *
+ * @param grey Array of REFLECTANCE_SENSOR_CHANNELS grey-scale values obtained from Reflectance_Sensor_Normalize().
+ *
+ * @param position Pointer to store the position in 0.1mm relative to the center of the line.
+ *                 If no line is detected, the same default value as Reflectance_Sensor_Position() is stored.
+ *
+ * @return 0x01 if a line is detected. Otherwise, returns 0x00.
+ */
+uint8_t Reflectance_Sensor_Analog_Position(const uint16_t grey[], int32_t *position);
+
 #endif /* INC_REFLECTANCE_SENSOR_H_ */
@@ -25,6 +25,24 @@
 #include "../inc/Clock.h"
 #include "../inc/Timer_A3_Capture.h"
 
+// Number of periods averaged by Tachometer_Get_Average() (must be a power of two)
+#define TACHOMETER_PERIOD_BUFFER_SIZE 8
+
+// Number of periods used by the median spike filter
+#define TACHOMETER_MEDIAN_SIZE 5
+
+// Number of Timer A3 ticks (SMCLK = 12 MHz) per millisecond
+#define TACHOMETER_TICKS_PER_MS 12000
+
+// Default time without an edge after which a wheel is reported as stopped
+#define TACHOMETER_DEFAULT_STALL_TIMEOUT_MS 250
+
+// Longest stall timeout accepted by Tachometer_Set_Stall_Timeout(), which keeps the period sums within 32 bits
+#define TACHOMETER_MAX_STALL_TIMEOUT_MS 10000
+
+// RPM = (60 s * 12,000,000 ticks per second) / (360 steps per revolution * period in ticks)
+#define TACHOMETER_RPM_CONSTANT 2000000
+
 /**
  * @brief Indicates the direction of the motor rotation relative to the front of the robot
  */
@@ -35,6 +53,40 @@ enum Tachometer_Direction
     REVERSE
 };
 
+/**
+ * @brief State of one wheel in a Tachometer_Snapshot.
+ */
+typedef struct
+{
+    // Last measured period and average period (units of 83.3 ns), or 0 if the wheel is stopped
+    uint32_t Period;
+    uint32_t Average_Period;
+
+    // Total number of steps (incremented forward, decremented backward)
+    int32_t Steps;
+
+    // Direction of the last movement, or STOPPED if the wheel is stopped
+    enum Tachometer_Direction Direction;
+
+    // 32-bit time of the last edge (see Timer_A3_Capture_Extend())
+    uint32_t Edge_Time;
+} Tachometer_Wheel_State;
+
+/**
+ * @brief Consistent state of both wheels taken at one point in time.
+ */
+typedef struct
+{
+    Tachometer_Wheel_State Left;
+    Tachometer_Wheel_State Right;
+
+    // 32-bit time at which the snapshot was taken (see Timer_A3_Capture_Now())
+    uint32_t Time;
+
+    // Increases by 2 for every encoder edge, so a reader can tell whether any edge occurred since its last snapshot
+    uint32_t Sequence;
+} Tachometer_Snapshot;
+
 /**
  * @brief Initialize the tachometer interface.
  *
@@ -49,13 +101,30 @@ enum Tachometer_Direction
  */
 void Tachometer_Init();
 
+/**
+ * @brief Take a consistent snapshot of the state of both wheels.
+ *
+ * The capture interrupts update a sequence counter before and after every change, and the state is copied
+ * again if an edge was handled during the copy. All fields of the snapshot therefore belong to the same set
+ * of edges. Interrupts are not disabled, so the capture interrupts are never delayed by a reader.
+ *
+ * @param snapshot Pointer to store the snapshot.
+ *
+ * @note Assumes Tachometer_Init() has been called
+ *
+ * @note Must not be called from the Timer A3 capture interrupts.
+ *
+ * @return None
+ */
+void Tachometer_Get_Snapshot(Tachometer_Snapshot *snapshot);
+
 /**
  * @brief Get the tachometer measurements.
  *
- * @param left_tach:    Pointer to store the last measured tachometer period of the left wheel (units of 83.3 ns)
+ * @param left_tach:    Pointer to store the last measured tachometer period of the left wheel (units of 83.3 ns), saturated to 0xFFFF
  * @param left_dir:     Pointer to store the enumerated direction of last movement of the left wheel
  * @param left_steps:   Pointer to store the total number of forward steps measured for the left wheel (360 steps per ~220 mm circumference)
- * @param right_tach:   Pointer to store the last measured tachometer period of the right wheel (units of 83.3 ns)
+ * @param right_tach:   Pointer to store the last measured tachometer period of the right wheel (units of 83.3 ns), saturated to 0xFFFF
  * @param right_dir:    Pointer to store the enumerated direction of last movement of the right wheel
  * @param right_steps:  Pointer to store the total number of forward steps measured for the right wheel (360 steps per ~220 mm circumference)
  *
@@ -63,6 +132,9 @@ void Tachometer_Init();
  *
  * @note Assumes Clock_Init48MHz() has been called
  *
+ * @note If a wheel has not produced an edge within the stall timeout, its period is reported as 0
+ *       and its direction as STOPPED.
+ *
  * @return None
  */
 void Tachometer_Get(uint16_t *left_tach,
@@ -72,6 +144,61 @@ void Tachometer_Get(uint16_t *left_tach,
                     enum Tachometer_Direction *right_dir,
                     int32_t *right_steps);
 
+/**
+ * @brief Get the average tachometer periods of both wheels.
+ *
+ * The Timer A3 capture interrupts push every measured period into a ring buffer of
+ * TACHOMETER_PERIOD_BUFFER_SIZE periods per wheel and update the sum of the buffer incrementally,
+ * so this function only divides the sums and does not depend on the buffer size.
+ * If the median filter is enabled, the median of the last TACHOMETER_MEDIAN_SIZE periods is pushed
+ * instead of the raw period, which removes isolated spikes caused by missed or extra edges.
+ *
+ * Periods are measured with 32-bit times, so they remain correct when Timer A3 wraps between two edges.
+ * A period longer than the stall timeout starts a new history.
+ *
+ * @param left_tach:    Pointer to store the average period of the left wheel (units of 83.3 ns), or 0 if the wheel is stopped
+ * @param right_tach:   Pointer to store the average period of the right wheel (units of 83.3 ns), or 0 if the wheel is stopped
+ *
+ * @note Assumes Tachometer_Init() has been called
+ *
+ * @return None
+ */
+void Tachometer_Get_Average(uint32_t *left_tach, uint32_t *right_tach);
+
+/**
+ * @brief Get the speed of both wheels in revolutions per minute.
+ *
+ * The speed is computed from the average periods of Tachometer_Get_Average() and is negative
+ * when the wheel turns backward. A wheel that has not produced an edge within the stall timeout
+ * is reported with a speed of 0.
+ *
+ * @param left_rpm:     Pointer to store the speed of the left wheel (RPM)
+ * @param right_rpm:    Pointer to store the speed of the right wheel (RPM)
+ *
+ * @note Assumes Tachometer_Init() has been called
+ *
+ * @return None
+ */
+void Tachometer_Get_RPM(int16_t *left_rpm, int16_t *right_rpm);
+
+/**
+ * @brief Set the time without an edge after which a wheel is reported as stopped.
+ *
+ * @param timeout_ms The stall timeout in milliseconds (at most TACHOMETER_MAX_STALL_TIMEOUT_MS).
+ *
+ * @return None
+ */
+void Tachometer_Set_Stall_Timeout(uint32_t timeout_ms);
+
+/**
+ * @brief Enable or disable the median-of-5 spike filter applied before averaging.
+ *
+ * @param enable Set to 1 to enable the filter, or 0 to average the raw periods.
+ *
+ * @return None
+ */
+void Tachometer_Set_Median_Filter(uint8_t enable);
+
 /**
  * @brief Calculate the average of an unsigned integer buffer.
  *
@@ -0,0 +1,110 @@
+/**
+ * @file Timer32_OneShot.h
+ * @brief Header file for the Timer32_OneShot driver.
+ *
+ * This file contains the function definitions for the Timer32_OneShot driver.
+ * It uses a Timer32 module in one-shot mode to call a user-defined function once after
+ * a specified delay, without blocking the CPU while waiting. Timer32_OneShot_Init(),
+ * Timer32_OneShot_Start(), and Timer32_OneShot_Stop() use the first module (TIMER32_1),
+ * while the Timer32_OneShot_Timer_* functions can use either module.
+ *
+ * @note Timer32 is clocked by MCLK. The delay is converted to clock cycles using Clock_GetFreq().
+ *
+ * @author Aaron Nanas
+ *
+ */
+
+#ifndef INC_TIMER32_ONESHOT_H_
+#define INC_TIMER32_ONESHOT_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Clock.h"
+
+/**
+ * @brief Selects one of the two Timer32 modules.
+ */
+typedef enum
+{
+    TIMER32_ONESHOT_1 = 0,  ///< TIMER32_1 (IRQ 25)
+    TIMER32_ONESHOT_2 = 1   ///< TIMER32_2 (IRQ 26)
+} Timer32_OneShot_Timer;
+
+/**
+ * @brief Initialize a Timer32 module for one-shot interrupt generation.
+ *
+ * This function halts the timer, configures it as a 32-bit one-shot timer with a prescale value of 1,
+ * and enables its interrupt in the NVIC. The timer does not start counting until
+ * Timer32_OneShot_Timer_Start() is called.
+ *
+ * @param timer The Timer32 module to use.
+ *
+ * @param priority The NVIC priority level of the timer interrupt (0 to 7).
+ *
+ * @return None
+ */
+void Timer32_OneShot_Timer_Init(Timer32_OneShot_Timer timer, uint8_t priority);
+
+/**
+ * @brief Start a one-shot delay on a Timer32 module that calls a user-defined function when it expires.
+ *
+ * Any delay that is already pending on the same module is cancelled. The user-defined function is called
+ * from the interrupt service routine of the module, so it may start the next delay.
+ *
+ * @param timer The Timer32 module to use.
+ *
+ * @param task A pointer to the user-defined function to be executed when the delay expires.
+ *
+ * @param delay_us The delay in microseconds (must be non-zero).
+ *
+ * @note Assumes that Timer32_OneShot_Timer_Init() has been called for the module.
+ *
+ * @return None
+ */
+void Timer32_OneShot_Timer_Start(Timer32_OneShot_Timer timer, void(*task)(void), uint32_t delay_us);
+
+/**
+ * @brief Cancel a pending one-shot delay on a Timer32 module.
+ *
+ * @param timer The Timer32 module to use.
+ *
+ * @return None
+ */
+void Timer32_OneShot_Timer_Stop(Timer32_OneShot_Timer timer);
+
+/**
+ * @brief Initialize TIMER32_1 for one-shot interrupt generation.
+ *
+ * This function halts TIMER32_1, configures it as a 32-bit one-shot timer with a prescale value of 1,
+ * and enables its interrupt (IRQ 25) in the NVIC with a priority level of 2. The timer does not start counting until
+ * Timer32_OneShot_Start() is called.
+ *
+ * @return None
+ */
+void Timer32_OneShot_Init(void);
+
+/**
+ * @brief Start a one-shot delay that calls a user-defined function when it expires.
+ *
+ * Any delay that is already pending is cancelled. The user-defined function is called from
+ * the T32_INT1_IRQHandler interrupt service routine, so it may call Timer32_OneShot_Start()
+ * again to schedule the next step of a sequence.
+ *
+ * @param task A pointer to the user-defined function to be executed when the delay expires.
+ *
+ * @param delay_us The delay in microseconds (must be non-zero).
+ *
+ * @note Assumes that Timer32_OneShot_Init() has been called.
+ *
+ * @return None
+ */
+void Timer32_OneShot_Start(void(*task)(void), uint32_t delay_us);
+
+/**
+ * @brief Cancel a pending one-shot delay.
+ *
+ * @return None
+ */
+void Timer32_OneShot_Stop(void);
+
+#endif /* INC_TIMER32_ONESHOT_H_ */
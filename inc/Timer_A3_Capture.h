@@ -43,4 +43,27 @@ void (*Timer_A3_Capture_Task_1)(uint16_t time);
  */
 void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t time));
 
+/**
+ * @brief Extend a captured 16-bit time to 32 bits using the Timer A3 overflow count.
+ *
+ * Timer A3 requests an interrupt every time it wraps from 0xFFFF to 0x0000 (every 5.46 ms) and counts
+ * the overflows. If a capture occurs just after a wrap whose interrupt has not been handled yet,
+ * the pending overflow is included. The extended time wraps after about 358 seconds, so differences
+ * between two extended times are valid for periods of up to that length.
+ *
+ * @param time The 16-bit time passed to a capture task.
+ *
+ * @note Must be called from the capture task that received the time.
+ *
+ * @return The 32-bit time (in units of 83.3 ns).
+ */
+uint32_t Timer_A3_Capture_Extend(uint16_t time);
+
+/**
+ * @brief Read the current 32-bit time of Timer A3.
+ *
+ * @return The current time in the same 32-bit format as Timer_A3_Capture_Extend() (in units of 83.3 ns).
+ */
+uint32_t Timer_A3_Capture_Now(void);
+
 #endif /* INC_TIMER_A3_CAPTURE_H_ */
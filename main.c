@@ -20,9 +20,44 @@
 #include "inc/Motor.h"
 #include "inc/BLE_UART.h"
 #include "inc/GyroParser.h" // Include the parser header for processing BLE packets
+#include "inc/Tachometer.h"
+#include "inc/Odometry.h"
+#include "inc/Heading_Fusion.h"
+#include "inc/Timer_A1_Interrupt.h"
+#include "inc/Latency.h"
 
 #define BLE_UART_BUFFER_SIZE 128 // Define the maximum buffer size for BLE UART data
 
+// Rate of the control loop that runs from the Timer_A1 periodic interrupt (SMCLK = 12 MHz)
+#define CONTROL_RATE_HZ 200
+#define CONTROL_TIMER_PERIOD (12000000 / CONTROL_RATE_HZ)
+
+// Tilt beyond which an axis commands the motors (0.2 in Q16.16)
+#define GYRO_TILT_THRESHOLD GYRO_Q16_FROM_MILLI(200)
+
+// Set to 0 to drive straight with fixed, equal duty cycles instead of holding the heading
+#define HEADING_HOLD_MODE 1
+
+// Duty cycle range used while holding the heading (the Timer_A0 period is 15000)
+#define HEADING_HOLD_MIN_DUTY 2000
+#define HEADING_HOLD_MAX_DUTY 6000
+#define HEADING_HOLD_DUTY_LIMIT 14000
+
+// PI gains: correction = KP * error + (integral of error >> KI_SHIFT), with the error in milliradians
+#define HEADING_HOLD_KP 5
+#define HEADING_HOLD_KI_SHIFT 6
+#define HEADING_HOLD_MAX_CORRECTION 1500
+
+// Number of valid packets between the packet-to-motor latency reports on the serial console (10 s at 20 Hz)
+#define LATENCY_REPORT_PACKETS 200
+
+// Heading-hold state shared between MotorControlFromGyro() and the control loop
+static volatile uint8_t Heading_Hold_Active = 0;
+static volatile uint8_t Heading_Hold_Forward = 1;
+static volatile uint16_t Heading_Hold_Base_Duty = 0;
+static volatile uint32_t Heading_Hold_Target = 0;
+static int32_t Heading_Hold_Integral = 0;
+
 /**
  * @brief Controls motor movements based on gyroscope data.
  *
@@ -31,11 +66,22 @@
  * - **Left/Right**: Controlled by the `x` axis.
  * - **Stop**: Stops the motor if the `x` and `y` values are within a threshold.
  *
- * @param x Gyroscope X-axis value.
- * @param y Gyroscope Y-axis value.
- * @param z Gyroscope Z-axis value (not used in motor control).
+ * - **Heading Hold**: While driving straight, the `y` axis sets the speed and the control loop
+ *   keeps the heading that the platform had when straight driving started.
+ *
+ * @param x Gyroscope X-axis value in Q16.16.
+ * @param y Gyroscope Y-axis value in Q16.16.
+ * @param z Gyroscope Z-axis value in Q16.16 (forwarded to the heading estimate).
+ */
+void MotorControlFromGyro(int32_t x, int32_t y, int32_t z);
+
+/**
+ * @brief Runs the control loop at CONTROL_RATE_HZ from the Timer_A1 periodic interrupt.
+ *
+ * Updates the odometry and the fused heading, and while heading hold is active, applies a PI
+ * correction to the left and right duty cycles so that the platform keeps its target heading.
  */
-void MotorControlFromGyro(float x, float y, float z);
+void Control_Task(void);
 
 int main(void) {
     // Disable interrupts during initialization to prevent unwanted behavior
@@ -45,8 +91,13 @@ int main(void) {
     Clock_Init48MHz();           // Set the system clock to 48 MHz
     LED2_Init();                 // Initialize the on-board RGB LED
     EUSCI_A0_UART_Init_Printf(); // Initialize UART for debugging via the serial console
+    Latency_Init();              // Measure the delay from each packet to the motors
     BLE_UART_Init();             // Initialize BLE UART for communication
     Motor_Init();                // Initialize motor control functionality
+    Tachometer_Init();           // Initialize the wheel encoders
+    Odometry_Init();             // Start the odometry at the origin
+    Heading_Fusion_Init(CONTROL_RATE_HZ);                          // Fuse the phone gyro with the wheels
+    Timer_A1_Interrupt_Init(&Control_Task, CONTROL_TIMER_PERIOD); // Run the control loop periodically
 
     // Enable global interrupts
     EnableInterrupts();
@@ -56,6 +107,7 @@ int main(void) {
     BLE_UART_OutString("BLE UART Ready\r\n");
 
     uint8_t BLE_UART_Buffer[BLE_UART_BUFFER_SIZE] = {0}; // Buffer for storing BLE UART data
+    uint32_t valid_packets = 0;
 
     while (1) {
         // Read the BLE data into the buffer
@@ -71,17 +123,22 @@ int main(void) {
             }
             EUSCI_A0_UART_OutString("\r\n");
 
-            // Parse the BLE packet for validation and processing
-            ParseBLEPacket(BLE_UART_Buffer);
+            // Parse the BLE packet into Q16.16 gyroscope values, and skip corrupted packets
+            Gyro_Sample gyro;
+            if (!ParseGyroPacket(BLE_UART_Buffer, (uint16_t)string_size, &gyro)) {
+                continue;
+            }
 
-            // Extract gyroscope float values for motor control
-            float x, y, z;
-            x = ExtractFloat(BLE_UART_Buffer, 2);  // Extract X-axis value from buffer
-            y = ExtractFloat(BLE_UART_Buffer, 6);  // Extract Y-axis value from buffer
-            z = ExtractFloat(BLE_UART_Buffer, 10); // Extract Z-axis value from buffer
+            // Measure the latency of this packet until its command reaches the motors
+            Latency_Mark_Valid();
 
             // Control the motors based on parsed gyroscope data
-            MotorControlFromGyro(x, y, z);
+            MotorControlFromGyro(gyro.X, gyro.Y, gyro.Z);
+
+            // Periodically report the packet-to-motor latency histogram
+            if (++valid_packets % LATENCY_REPORT_PACKETS == 0) {
+                Latency_Print_Histogram();
+            }
         }
     }
 }
@@ -90,34 +147,122 @@ int main(void) {
  * @brief Controls motor movements based on gyroscope data.
  *
  * Uses the parsed gyroscope data to control motor actions:
- * - **Forward/Backward**: Based on the `y` axis.
+ * - **Forward/Backward**: Based on the `y` axis. With HEADING_HOLD_MODE, the magnitude of `y`
+ *   sets the speed and the control loop holds the heading.
  * - **Left/Right**: Based on the `x` axis.
  * - **Stop**: If `x` and `y` values are within a certain range, stop the motors.
  *
- * @param x Gyroscope X-axis value.
- * @param y Gyroscope Y-axis value.
- * @param z Gyroscope Z-axis value (not used here).
+ * @param x Gyroscope X-axis value in Q16.16.
+ * @param y Gyroscope Y-axis value in Q16.16.
+ * @param z Gyroscope Z-axis value in Q16.16 (used by the heading estimate).
  */
-void MotorControlFromGyro(float x, float y, float z) {
-    if (y > 0.2) {
+void MotorControlFromGyro(int32_t x, int32_t y, int32_t z) {
+    // ExtractQ16() saturates to +/-GYRO_Q16_MAX, so the magnitudes cannot overflow
+    int32_t abs_x = (x < 0) ? -x : x;
+    int32_t abs_y = (y < 0) ? -y : y;
+
+    // Pass the Z rate to the heading estimate in milliradians per second
+    Heading_Fusion_Set_Gyro_Rate((int32_t)(((int64_t)z * 1000) >> GYRO_Q16_SHIFT));
+
+#if HEADING_HOLD_MODE
+    // Hold the heading while driving straight (only `y` outside of the threshold)
+    if (abs_x <= GYRO_TILT_THRESHOLD && abs_y > GYRO_TILT_THRESHOLD) {
+        uint8_t forward = (y > 0);
+
+        // Map the tilt from the threshold up to 1.0 onto the heading-hold duty cycle range
+        uint32_t tilt = (uint32_t)(abs_y - GYRO_TILT_THRESHOLD);
+        if (tilt > (GYRO_Q16_ONE - GYRO_TILT_THRESHOLD)) {
+            tilt = (GYRO_Q16_ONE - GYRO_TILT_THRESHOLD);
+        }
+        uint16_t duty = HEADING_HOLD_MIN_DUTY +
+                        (uint16_t)((tilt * (HEADING_HOLD_MAX_DUTY - HEADING_HOLD_MIN_DUTY)) / (GYRO_Q16_ONE - GYRO_TILT_THRESHOLD));
+
+        // Capture the heading to hold when straight driving starts or changes direction
+        if (!Heading_Hold_Active || (forward != Heading_Hold_Forward)) {
+            Heading_Fusion_State heading;
+            Heading_Fusion_Get(&heading);
+
+            Heading_Hold_Active = 0;
+            Heading_Hold_Target = heading.Heading;
+            Heading_Hold_Integral = 0;
+            Heading_Hold_Forward = forward;
+        }
+
+        Heading_Hold_Base_Duty = duty;
+        Heading_Hold_Active = 1;
+        EUSCI_A0_UART_OutString(forward ? "Motor: Heading Hold Forward\r\n" : "Motor: Heading Hold Backward\r\n");
+        return;
+    }
+
+    // Any other command takes the motors back from the control loop
+    Heading_Hold_Active = 0;
+#endif
+
+    if (y > GYRO_TILT_THRESHOLD) {
         Motor_Forward(3000, 3000); // Move forward
         EUSCI_A0_UART_OutString("Motor: Moving Forward\r\n");
-    } else if (y < -0.2) {
+    } else if (y < -GYRO_TILT_THRESHOLD) {
         Motor_Backward(3000, 3000); // Move backward
         EUSCI_A0_UART_OutString("Motor: Moving Backward\r\n");
     }
 
-    if (x > 0.2) {
+    if (x > GYRO_TILT_THRESHOLD) {
         Motor_Right(3000, 3000); // Turn right
         EUSCI_A0_UART_OutString("Motor: Turning Right\r\n");
-    } else if (x < -0.2) {
+    } else if (x < -GYRO_TILT_THRESHOLD) {
         Motor_Left(3000, 3000); // Turn left
         EUSCI_A0_UART_OutString("Motor: Turning Left\r\n");
     }
 
     // Stop the motors if both `x` and `y` values are within the threshold
-    if (fabs(x) <= 0.2 && fabs(y) <= 0.2) {
+    if (abs_x <= GYRO_TILT_THRESHOLD && abs_y <= GYRO_TILT_THRESHOLD) {
         Motor_Stop(); // Stop the motors
         EUSCI_A0_UART_OutString("Motor: Stopped\r\n");
     }
 }
+
+void Control_Task(void) {
+    // Integrate the wheel steps and the gyroscope into the pose and the fused heading
+    Odometry_Update();
+    Heading_Fusion_Update();
+
+    if (!Heading_Hold_Active) {
+        return;
+    }
+
+    Heading_Fusion_State heading;
+    Heading_Fusion_Get(&heading);
+
+    // Heading error in milliradians (positive when the platform must turn counterclockwise)
+    int32_t error = (int32_t)(Heading_Hold_Target - heading.Heading) / HEADING_FUSION_BINARY_ANGLE_PER_MRAD;
+
+    // Integrate the error, limiting the integral so that it cannot wind up beyond the maximum correction
+    Heading_Hold_Integral += error;
+    if (Heading_Hold_Integral > (HEADING_HOLD_MAX_CORRECTION << HEADING_HOLD_KI_SHIFT)) {
+        Heading_Hold_Integral = (HEADING_HOLD_MAX_CORRECTION << HEADING_HOLD_KI_SHIFT);
+    } else if (Heading_Hold_Integral < -(HEADING_HOLD_MAX_CORRECTION << HEADING_HOLD_KI_SHIFT)) {
+        Heading_Hold_Integral = -(HEADING_HOLD_MAX_CORRECTION << HEADING_HOLD_KI_SHIFT);
+    }
+
+    int32_t correction = (HEADING_HOLD_KP * error) + (Heading_Hold_Integral >> HEADING_HOLD_KI_SHIFT);
+    if (correction > HEADING_HOLD_MAX_CORRECTION) {
+        correction = HEADING_HOLD_MAX_CORRECTION;
+    } else if (correction < -HEADING_HOLD_MAX_CORRECTION) {
+        correction = -HEADING_HOLD_MAX_CORRECTION;
+    }
+
+    // Turning counterclockwise needs a faster right wheel when driving forward
+    // and a faster left wheel when driving backward
+    int32_t base = Heading_Hold_Base_Duty;
+    int32_t left = Heading_Hold_Forward ? (base - correction) : (base + correction);
+    int32_t right = Heading_Hold_Forward ? (base + correction) : (base - correction);
+
+    left = (left < 0) ? 0 : ((left > HEADING_HOLD_DUTY_LIMIT) ? HEADING_HOLD_DUTY_LIMIT : left);
+    right = (right < 0) ? 0 : ((right > HEADING_HOLD_DUTY_LIMIT) ? HEADING_HOLD_DUTY_LIMIT : right);
+
+    if (Heading_Hold_Forward) {
+        Motor_Forward((uint16_t)left, (uint16_t)right);
+    } else {
+        Motor_Backward((uint16_t)left, (uint16_t)right);
+    }
+}
@@ -16,7 +16,85 @@
  *
  */
 
+#include <stddef.h>
+#include <string.h>
 #include "../inc/Analog_Distance_Sensors.h"
+#include "../inc/HAL.h"
+
+// Unclamped distance (in mm) for entry i of the default table, as computed by Analog_Distance_Sensor_Build_Table()
+#define DEFAULT_DISTANCE_RAW(i) \
+    ((((i) << ANALOG_DISTANCE_LUT_SHIFT) >= ANALOG_DISTANCE_SENSOR_MAX) && ((((i) << ANALOG_DISTANCE_LUT_SHIFT) + Bx) > 0) \
+        ? ((Ax / ((((i) << ANALOG_DISTANCE_LUT_SHIFT) + Bx) > 0 ? (((i) << ANALOG_DISTANCE_LUT_SHIFT) + Bx) : 1)) + Cx) \
+        : 800)
+
+// Entry i of the default table, limited to the 0 to 800 mm range of the sensor
+#define DEFAULT_DISTANCE_ENTRY(i) \
+    ((DEFAULT_DISTANCE_RAW(i) > 800) ? 800 : ((DEFAULT_DISTANCE_RAW(i) < 0) ? 0 : DEFAULT_DISTANCE_RAW(i)))
+
+// Eight consecutive entries of the default table, starting at entry 8 * row
+#define DEFAULT_DISTANCE_ROW(row) \
+    DEFAULT_DISTANCE_ENTRY(8 * (row) + 0), DEFAULT_DISTANCE_ENTRY(8 * (row) + 1), \
+    DEFAULT_DISTANCE_ENTRY(8 * (row) + 2), DEFAULT_DISTANCE_ENTRY(8 * (row) + 3), \
+    DEFAULT_DISTANCE_ENTRY(8 * (row) + 4), DEFAULT_DISTANCE_ENTRY(8 * (row) + 5), \
+    DEFAULT_DISTANCE_ENTRY(8 * (row) + 6), DEFAULT_DISTANCE_ENTRY(8 * (row) + 7)
+
+#if ANALOG_DISTANCE_LUT_SIZE != 129
+#error "Default_Distance_Table is expanded for 129 entries (ANALOG_DISTANCE_LUT_SHIFT = 7)"
+#endif
+
+/**
+ * @brief Default distance lookup table shared by all sensors before calibration.
+ *
+ * Entry i holds the calibrated distance (in mm) for a filtered reading of i * 128, using
+ * Dx = (Ax / (filtered_distance + Bx) + Cx) with the default Ax, Bx, and Cx coefficients.
+ * Readings below ANALOG_DISTANCE_SENSOR_MAX are mapped to 800 mm, and the table is limited to 800 mm.
+ *
+ * The entries are computed by the compiler from Ax, Bx, and Cx with the same integer arithmetic
+ * as Analog_Distance_Sensor_Build_Table(), so the table follows any change of the coefficients.
+ */
+static const uint16_t Default_Distance_Table[ANALOG_DISTANCE_LUT_SIZE] =
+{
+    DEFAULT_DISTANCE_ROW(0),  DEFAULT_DISTANCE_ROW(1),  DEFAULT_DISTANCE_ROW(2),  DEFAULT_DISTANCE_ROW(3),
+    DEFAULT_DISTANCE_ROW(4),  DEFAULT_DISTANCE_ROW(5),  DEFAULT_DISTANCE_ROW(6),  DEFAULT_DISTANCE_ROW(7),
+    DEFAULT_DISTANCE_ROW(8),  DEFAULT_DISTANCE_ROW(9),  DEFAULT_DISTANCE_ROW(10), DEFAULT_DISTANCE_ROW(11),
+    DEFAULT_DISTANCE_ROW(12), DEFAULT_DISTANCE_ROW(13), DEFAULT_DISTANCE_ROW(14), DEFAULT_DISTANCE_ROW(15),
+    DEFAULT_DISTANCE_ENTRY(128)
+};
+
+// Per-sensor lookup tables used by Analog_Distance_Sensor_Convert()
+static uint16_t Distance_Table[ANALOG_DISTANCE_SENSOR_COUNT][ANALOG_DISTANCE_LUT_SIZE];
+
+// Calibration points captured for each sensor: filtered readings and known distances (in mm)
+static uint32_t Calibration_Reading[ANALOG_DISTANCE_SENSOR_COUNT][ANALOG_DISTANCE_CALIBRATION_MAX_POINTS];
+static int32_t Calibration_Distance[ANALOG_DISTANCE_SENSOR_COUNT][ANALOG_DISTANCE_CALIBRATION_MAX_POINTS];
+static uint8_t Calibration_Count[ANALOG_DISTANCE_SENSOR_COUNT];
+
+/**
+ * @brief Interpolate between two adjacent breakpoints of a distance lookup table.
+ *
+ * @param table Pointer to the lookup table.
+ *
+ * @param filtered_distance The filtered reading (0 to 16383). Larger values are limited to 16383.
+ *
+ * @return The interpolated distance in mm.
+ */
+static int32_t Distance_Table_Lookup(const uint16_t *table, uint32_t filtered_distance)
+{
+    // Limit the reading to the 14-bit ADC range
+    if (filtered_distance > 0x3FFF)
+    {
+        filtered_distance = 0x3FFF;
+    }
+
+    // The upper 7 bits select the segment, while the lower 7 bits select the position within it
+    uint32_t index = filtered_distance >> ANALOG_DISTANCE_LUT_SHIFT;
+    int32_t fraction = filtered_distance & ((1 << ANALOG_DISTANCE_LUT_SHIFT) - 1);
+
+    int32_t start = table[index];
+    int32_t end = table[index + 1];
+
+    return start + (((end - start) * fraction) >> ANALOG_DISTANCE_LUT_SHIFT);
+}
 
 void Analog_Distance_Sensor_Init()
 {
@@ -24,7 +102,7 @@ void Analog_Distance_Sensor_Init()
     ADC14->CTL0 &= ~0x00000002;
 
     // Wait for ADC14BUSY (Bit 16) to be 0
-    while(ADC14->CTL0 & 0x00010000);
+    HAL_WAIT_WHILE(ADC14->CTL0 & 0x00010000);
 
     //     CTL0 Register Configuration
     //
@@ -116,12 +194,19 @@ void Analog_Distance_Sensor_Init()
 
     // Set ADC14ENC (Bit 1) to 1 to enable conversion
     ADC14->CTL0 |= 0x00000002;
+
+    // Load the default calibration into the lookup table of each sensor
+    for (int sensor = 0; sensor < ANALOG_DISTANCE_SENSOR_COUNT; sensor++)
+    {
+        memcpy(Distance_Table[sensor], Default_Distance_Table, sizeof(Default_Distance_Table));
+        Calibration_Count[sensor] = 0;
+    }
 }
 
 void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, uint32_t *Ch_16)
 {
     // Wait for ADC14BUSY (Bit 16) to be 0
-    while(ADC14->CTL0 & 0x00010000);
+    HAL_WAIT_WHILE(ADC14->CTL0 & 0x00010000);
 
     // Start sample-and-conversion
     // Note: ADC14SC is reset automatically
@@ -129,7 +214,7 @@ void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, u
 
     // Wait for ADC14IFG4 to be set (when ADC14MEM4 is loaded with a conversion result)
     // Note: This bit is reset to 0 when the ADC14MEM4 register is read (i.e. when the last channel, A16, is read)
-    while((ADC14->IFGR0 & 0x10) == 0);
+    HAL_WAIT_WHILE((ADC14->IFGR0 & 0x10) == 0);
 
     // Read the result of P9.0 (A17) from the MEM[2] register (0 to 16383)
     *Ch_17 = ADC14->MEM[2];
@@ -143,12 +228,152 @@ void Analog_Distance_Sensor_Start_Conversion(uint32_t *Ch_17, uint32_t *Ch_14, u
 
 int32_t Analog_Distance_Sensor_Calibrate(int filtered_distance)
 {
-    // If the filtered distance (after LPF) is less than the max, return 800 mm
-    if (filtered_distance < ANALOG_DISTANCE_SENSOR_MAX)
+    // Negative readings cannot come from the ADC, so treat them as out of range (800 mm)
+    if (filtered_distance < 0)
     {
         return 800;
     }
 
-    // Otherwise, calculate the calibrated distance using the calibration formula
-    return (Ax / (filtered_distance + Bx) + Cx);
+    return Distance_Table_Lookup(Default_Distance_Table, filtered_distance);
+}
+
+int32_t Analog_Distance_Sensor_Convert(enum Analog_Distance_Sensor_Index sensor, uint32_t filtered_distance)
+{
+    return Distance_Table_Lookup(Distance_Table[sensor], filtered_distance);
+}
+
+void Analog_Distance_Sensor_Build_Table(enum Analog_Distance_Sensor_Index sensor, Analog_Distance_Sensor_Coefficients coefficients)
+{
+    for (int i = 0; i < ANALOG_DISTANCE_LUT_SIZE; i++)
+    {
+        int32_t reading = i << ANALOG_DISTANCE_LUT_SHIFT;
+        int32_t denominator = reading + coefficients.B;
+        int32_t distance = 800;
+
+        // Readings below the usable range (or below the asymptote of the formula) are reported as 800 mm
+        if ((reading >= ANALOG_DISTANCE_SENSOR_MAX) && (denominator > 0))
+        {
+            distance = (coefficients.A / denominator) + coefficients.C;
+        }
+
+        // Limit the table to the 0 to 800 mm range of the sensor
+        if (distance > 800) distance = 800;
+        if (distance < 0) distance = 0;
+
+        Distance_Table[sensor][i] = (uint16_t)distance;
+    }
+}
+
+void Analog_Distance_Sensor_Calibration_Reset(enum Analog_Distance_Sensor_Index sensor)
+{
+    Calibration_Count[sensor] = 0;
+}
+
+uint8_t Analog_Distance_Sensor_Calibration_Add_Point(enum Analog_Distance_Sensor_Index sensor, uint32_t filtered_distance, int32_t actual_distance)
+{
+    // Reject the point if the buffer for this sensor is full
+    if (Calibration_Count[sensor] >= ANALOG_DISTANCE_CALIBRATION_MAX_POINTS)
+    {
+        return 0x00;
+    }
+
+    Calibration_Reading[sensor][Calibration_Count[sensor]] = filtered_distance;
+    Calibration_Distance[sensor][Calibration_Count[sensor]] = actual_distance;
+    Calibration_Count[sensor]++;
+
+    return 0x01;
+}
+
+uint8_t Analog_Distance_Sensor_Calibration_Capture(enum Analog_Distance_Sensor_Index sensor, int32_t actual_distance, uint16_t num_samples)
+{
+    uint32_t Ch_17;
+    uint32_t Ch_14;
+    uint32_t Ch_16;
+    uint32_t reading_sum = 0;
+
+    if (num_samples == 0)
+    {
+        return 0x00;
+    }
+
+    // Average several conversions to reduce the noise of the calibration point
+    for (int i = 0; i < num_samples; i++)
+    {
+        Analog_Distance_Sensor_Start_Conversion(&Ch_17, &Ch_14, &Ch_16);
+
+        if (sensor == ANALOG_DISTANCE_SENSOR_RIGHT)
+        {
+            reading_sum = reading_sum + Ch_17;
+        }
+        else if (sensor == ANALOG_DISTANCE_SENSOR_CENTER)
+        {
+            reading_sum = reading_sum + Ch_14;
+        }
+        else
+        {
+            reading_sum = reading_sum + Ch_16;
+        }
+    }
+
+    return Analog_Distance_Sensor_Calibration_Add_Point(sensor, reading_sum / num_samples, actual_distance);
+}
+
+uint8_t Analog_Distance_Sensor_Calibration_Fit(enum Analog_Distance_Sensor_Index sensor, Analog_Distance_Sensor_Coefficients *coefficients)
+{
+    int64_t n = 0;
+    int64_t sum_d = 0;
+    int64_t sum_z = 0;
+    int64_t sum_dd = 0;
+    int64_t sum_dz = 0;
+
+    // With d = (Dx - C) and z = d * x, the calibration formula becomes z = A - B * d,
+    // which is fitted with an ordinary least-squares line
+    for (int i = 0; i < Calibration_Count[sensor]; i++)
+    {
+        int64_t d = Calibration_Distance[sensor][i] - Cx;
+        int64_t z = d * Calibration_Reading[sensor][i];
+
+        // Points at or closer than the C coefficient cannot be represented by the formula
+        if (d <= 0)
+        {
+            continue;
+        }
+
+        n++;
+        sum_d += d;
+        sum_z += z;
+        sum_dd += d * d;
+        sum_dz += d * z;
+    }
+
+    int64_t denominator = (n * sum_dd) - (sum_d * sum_d);
+
+    // At least two distinct distances are needed to determine the slope
+    if ((n < 2) || (denominator == 0))
+    {
+        return 0x00;
+    }
+
+    int64_t slope = ((n * sum_dz) - (sum_d * sum_z)) / denominator;
+    int64_t intercept = (sum_z - (slope * sum_d)) / n;
+
+    // A non-positive A would produce an increasing distance curve, which means the points are unusable
+    if ((intercept <= 0) || (intercept > INT32_MAX) || (slope > INT32_MAX) || (slope < -INT32_MAX))
+    {
+        return 0x00;
+    }
+
+    Analog_Distance_Sensor_Coefficients fitted;
+    fitted.A = (int32_t)intercept;
+    fitted.B = (int32_t)(-slope);
+    fitted.C = Cx;
+
+    Analog_Distance_Sensor_Build_Table(sensor, fitted);
+
+    if (coefficients != NULL)
+    {
+        *coefficients = fitted;
+    }
+
+    return 0x01;
 }
@@ -12,6 +12,8 @@
 
 #include "../inc/BLE_UART.h"
 #include "../inc/GyroParser.h"
+#include "../inc/HAL.h"
+#include "../inc/Latency.h"
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
@@ -55,8 +57,8 @@ void BLE_UART_Init() {
  * @return The character received from the UART RX buffer.
  */
 uint8_t BLE_UART_InChar() {
-    while (!(EUSCI_A3->IFG & 0x01)); // Wait for RX buffer to be ready
-    return EUSCI_A3->RXBUF;          // Return the received character
+    HAL_WAIT_WHILE(!(EUSCI_A3->IFG & 0x01)); // Wait for RX buffer to be ready
+    return HAL_EUSCI_READ_RXBUF(EUSCI_A3); // Return the received character
 }
 
 /**
@@ -67,8 +69,8 @@ uint8_t BLE_UART_InChar() {
  * @param data The character to transmit.
  */
 void BLE_UART_OutChar(uint8_t data) {
-    while (!(EUSCI_A3->IFG & 0x02)); // Wait for TX buffer to be ready
-    EUSCI_A3->TXBUF = data;          // Transmit the character
+    HAL_WAIT_WHILE(!(EUSCI_A3->IFG & 0x02)); // Wait for TX buffer to be ready
+    HAL_EUSCI_WRITE_TXBUF(EUSCI_A3, data); // Transmit the character
 }
 
 /**
@@ -77,6 +79,9 @@ void BLE_UART_OutChar(uint8_t data) {
  * Reads characters into a buffer until a full BLE packet is received
  * (starting with `!G` and ending with a checksum).
  *
+ * While searching for the prefix, every `!` starts a new packet at the beginning of the buffer,
+ * so the receiver resynchronizes on the next packet after a lost, truncated or corrupted byte.
+ *
  * @param buffer_pointer Pointer to the buffer where received data will be stored.
  * @param buffer_size The maximum size of the buffer.
  * @return The length of the received packet.
@@ -88,25 +93,23 @@ int BLE_UART_InString(char *buffer_pointer, uint16_t buffer_size) {
     while (length < buffer_size) {
         uint8_t character = BLE_UART_InChar();
 
-        if (state == 0 && character == 0x21) { // Look for '!'
-            *buffer_pointer++ = character;
+        if (state == 2) { // Collect the remaining bytes
+            buffer_pointer[length++] = character;
+
+            if (length == BLE_UART_PACKET_SIZE) { // Full packet (including checksum) received
+                break;
+            }
+        } else if (character == 0x21) { // Look for '!' (restarts the packet while searching)
+            Latency_Mark_Receive(); // Timestamp the first byte of the packet
+            buffer_pointer[0] = character;
             length = 1;
             state = 1;
         } else if (state == 1 && character == 0x47) { // Look for 'G'
-            *buffer_pointer++ = character;
-            length++;
+            buffer_pointer[length++] = character;
             state = 2;
-        } else if (state == 2) { // Collect the remaining bytes
-            *buffer_pointer++ = character;
-            length++;
-
-            if (length == 15) { // Full packet (including checksum) received
-                break;
-            }
         } else { // Reset on desynchronization
             state = 0;
             length = 0;
-            buffer_pointer = buffer_pointer - length;
         }
     }
 
@@ -136,7 +139,7 @@ void BLE_UART_OutString(char *pt) {
  * @param len The length of the received data.
  */
 void BLE_UART_HandleRxData(uint8_t *buffer, uint8_t len) {
-    if (len != 15 || buffer[0] != 0x21 || buffer[1] != 0x47) { // Validate frame size and prefix
+    if (len != BLE_UART_PACKET_SIZE || buffer[0] != 0x21 || buffer[1] != 0x47) { // Validate frame size and prefix
         BLE_UART_OutString("Error: Invalid data received\r\n");
         return;
     }
@@ -147,7 +150,7 @@ void BLE_UART_HandleRxData(uint8_t *buffer, uint8_t len) {
     }
 
     // Pass the valid packet to GyroParser for processing
-    ParseBLEPacket(buffer);
+    ParseBLEPacket(buffer, len);
 }
 
 /**
@@ -26,6 +26,7 @@
  */
 
 #include "../inc/Barcode_Scanner.h"
+#include "../inc/HAL.h"
 
 void Barcode_Scanner_Init()
 {
@@ -97,11 +98,11 @@ uint8_t Barcode_Scanner_InChar()
     // in the IFG register and wait if the flag is not set
     // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has
     // received a complete character
-    while((EUSCI_A2->IFG & 0x01) == 0);
+    HAL_WAIT_WHILE((EUSCI_A2->IFG & 0x01) == 0);
 
     // Return the data from the Receive Buffer (UCAxRXBUF)
     // Reading the UCAxRXBUF will reset the UCRXIFG flag
-    return EUSCI_A2->RXBUF;
+    return HAL_EUSCI_READ_RXBUF(EUSCI_A2);
 }
 
 void Barcode_Scanner_OutChar(uint8_t data)
@@ -109,11 +110,11 @@ void Barcode_Scanner_OutChar(uint8_t data)
     // Check the Transmit Interrupt flag (UCTXIFG, Bit 1)
     // in the IFG register and wait if the flag is not set
     // If the UCTXIFG is set, then the Transmit Buffer (UCAxTXBUF) is empty
-    while((EUSCI_A2->IFG & 0x02) == 0);
+    HAL_WAIT_WHILE((EUSCI_A2->IFG & 0x02) == 0);
 
     // Write the data to the Transmit Buffer (UCAxTXBUF)
     // Writing to the UCAxTXBUF will clear the UCTXIFG flag
-    EUSCI_A2->TXBUF = data;
+    HAL_EUSCI_WRITE_TXBUF(EUSCI_A2, data);
 }
 
 int Barcode_Scanner_Read(char *buffer_pointer, uint16_t buffer_size)
@@ -168,3 +169,221 @@ uint8_t Check_Barcode_Scanner_Command(char Barcode_Scanner_Buffer[], char *comma
         return 0x00;
     }
 }
+
+// Line that is currently being received by the interrupt-driven reader
+static char Barcode_Scanner_Assembly_Buffer[BARCODE_SCANNER_BUFFER_SIZE + 1];
+static uint16_t Barcode_Scanner_Assembly_Length = 0;
+
+// Most recently completed line
+static char Barcode_Scanner_Line_Buffer[BARCODE_SCANNER_BUFFER_SIZE + 1];
+static volatile uint16_t Barcode_Scanner_Line_Length = 0;
+
+// Set when a line has been completed and cleared when it is retrieved
+static volatile uint8_t Barcode_Scanner_Line_Ready = 0;
+
+// Pointer to the user-defined function called when a line is completed
+static void (*Barcode_Scanner_Line_Task)(const char *barcode, uint16_t length) = NULL;
+
+/**
+ * @brief Adds a received character to the line that is being assembled.
+ *
+ * @param character The character read from the Receive Buffer (UCAxRXBUF).
+ *
+ * @return None
+ */
+static void Barcode_Scanner_Process_Char(char character)
+{
+    if (character == CR)
+    {
+        // Publish the completed line and start assembling the next one
+        memcpy(Barcode_Scanner_Line_Buffer, Barcode_Scanner_Assembly_Buffer, Barcode_Scanner_Assembly_Length);
+        Barcode_Scanner_Line_Buffer[Barcode_Scanner_Assembly_Length] = 0;
+        Barcode_Scanner_Line_Length = Barcode_Scanner_Assembly_Length;
+        Barcode_Scanner_Line_Ready = 1;
+        Barcode_Scanner_Assembly_Length = 0;
+
+        if (Barcode_Scanner_Line_Task)
+        {
+            (*Barcode_Scanner_Line_Task)(Barcode_Scanner_Line_Buffer, Barcode_Scanner_Line_Length);
+        }
+    }
+
+    // Remove the previous character if the received character is a backspace character
+    else if (character == BS)
+    {
+        if (Barcode_Scanner_Assembly_Length)
+        {
+            Barcode_Scanner_Assembly_Length--;
+
+            // Echo the backspace only if the Transmit Buffer is empty so that the handler never waits
+            if (EUSCI_A2->IFG & 0x02)
+            {
+                HAL_EUSCI_WRITE_TXBUF(EUSCI_A2, BS);
+            }
+        }
+    }
+
+    // Otherwise, store the character if there is space left in the buffer
+    else if ((character != LF) && (Barcode_Scanner_Assembly_Length < BARCODE_SCANNER_BUFFER_SIZE))
+    {
+        Barcode_Scanner_Assembly_Buffer[Barcode_Scanner_Assembly_Length] = character;
+        Barcode_Scanner_Assembly_Length++;
+    }
+}
+
+void Barcode_Scanner_Async_Init(void (*task)(const char *barcode, uint16_t length))
+{
+    // Disable the EUSCI_A2 interrupt in the NVIC while the reader state is reset
+    // by setting Bit 18 of the ICER register
+    NVIC->ICER[0] = 0x00040000;
+
+    Barcode_Scanner_Line_Task = task;
+    Barcode_Scanner_Assembly_Length = 0;
+    Barcode_Scanner_Line_Length = 0;
+    Barcode_Scanner_Line_Ready = 0;
+
+    // Disable the Transmit Interrupt (UCTXIE, Bit 1) since the Transmit Buffer
+    // is empty most of the time and would otherwise interrupt continuously
+    EUSCI_A2->IE &= ~0x02;
+
+    // Enable the Receive Interrupt (UCRXIE, Bit 0) in the IE register
+    EUSCI_A2->IE |= 0x01;
+
+    // Set interrupt priority level to 2 using the IPR4 register of NVIC
+    // EUSCI_A2 has an IRQ number of 18
+    NVIC->IP[4] = (NVIC->IP[4] & 0xFF00FFFF) | 0x00400000;
+
+    // Enable Interrupt 18 in NVIC by setting Bit 18 of the ISER register
+    NVIC->ISER[0] = 0x00040000;
+}
+
+uint8_t Barcode_Scanner_Get_Line(char *buffer_pointer, uint16_t buffer_size)
+{
+    if ((Barcode_Scanner_Line_Ready == 0) || (buffer_size == 0))
+    {
+        return 0x00;
+    }
+
+    // Prevent the handler from replacing the line while it is being copied
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint16_t length = Barcode_Scanner_Line_Length;
+
+    if (length > (buffer_size - 1))
+    {
+        length = buffer_size - 1;
+    }
+
+    memcpy(buffer_pointer, Barcode_Scanner_Line_Buffer, length);
+    buffer_pointer[length] = 0;
+    Barcode_Scanner_Line_Ready = 0;
+
+    __set_PRIMASK(primask);
+
+    return 0x01;
+}
+
+void EUSCIA2_IRQHandler(void)
+{
+    // Check the Receive Interrupt flag (UCRXIFG, Bit 0) in the IFG register
+    // Reading the UCAxRXBUF will reset the UCRXIFG flag
+    if (EUSCI_A2->IFG & 0x01)
+    {
+        Barcode_Scanner_Process_Char(HAL_EUSCI_READ_RXBUF(EUSCI_A2));
+    }
+}
+
+// Open-addressed table of registered barcode commands
+static Barcode_Scanner_Command Barcode_Scanner_Command_Table[BARCODE_SCANNER_COMMAND_TABLE_SIZE];
+
+// Number of registered barcode commands
+static uint8_t Barcode_Scanner_Command_Count = 0;
+
+/**
+ * @brief Finds the slot that holds a command or the empty slot where it would be stored.
+ *
+ * @param command Pointer to the characters of the command.
+ * @param length Number of characters in the command.
+ * @param hash The Barcode_Scanner_Hash() of the command.
+ *
+ * @return Pointer to the matching entry, or to the first empty entry on the probe sequence.
+ */
+static Barcode_Scanner_Command *Barcode_Scanner_Find_Slot(const char *command, uint16_t length, uint32_t hash)
+{
+    uint32_t index = hash & (BARCODE_SCANNER_COMMAND_TABLE_SIZE - 1);
+
+    // The table is never more than half full, so the probe always reaches an empty slot
+    while (Barcode_Scanner_Command_Table[index].Command != NULL)
+    {
+        Barcode_Scanner_Command *entry = &Barcode_Scanner_Command_Table[index];
+
+        if ((entry->Hash == hash) && (strncmp(entry->Command, command, length) == 0) && (entry->Command[length] == 0))
+        {
+            return entry;
+        }
+
+        index = (index + 1) & (BARCODE_SCANNER_COMMAND_TABLE_SIZE - 1);
+    }
+
+    return &Barcode_Scanner_Command_Table[index];
+}
+
+uint32_t Barcode_Scanner_Hash(const char *string, uint16_t length)
+{
+    // 32-bit FNV-1a with the standard offset basis and prime
+    uint32_t hash = 0x811C9DC5;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)string[i];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+uint8_t Barcode_Scanner_Register_Command(const char *command, void (*handler)(const char *barcode))
+{
+    if (Barcode_Scanner_Command_Count >= BARCODE_SCANNER_MAX_COMMANDS)
+    {
+        return 0x00;
+    }
+
+    uint16_t length = strlen(command);
+    uint32_t hash = Barcode_Scanner_Hash(command, length);
+    Barcode_Scanner_Command *entry = Barcode_Scanner_Find_Slot(command, length, hash);
+
+    if (entry->Command != NULL)
+    {
+        return 0x00;
+    }
+
+    // Store the handler before the command so that a concurrent dispatch never sees a partial entry
+    entry->Hash = hash;
+    entry->Handler = handler;
+    entry->Command = command;
+    Barcode_Scanner_Command_Count++;
+
+    return 0x01;
+}
+
+void Barcode_Scanner_Clear_Commands(void)
+{
+    memset(Barcode_Scanner_Command_Table, 0, sizeof(Barcode_Scanner_Command_Table));
+    Barcode_Scanner_Command_Count = 0;
+}
+
+uint8_t Barcode_Scanner_Dispatch(const char *barcode, uint16_t length)
+{
+    Barcode_Scanner_Command *entry = Barcode_Scanner_Find_Slot(barcode, length, Barcode_Scanner_Hash(barcode, length));
+
+    if ((entry->Command == NULL) || (entry->Handler == NULL))
+    {
+        return 0x00;
+    }
+
+    (*entry->Handler)(barcode);
+
+    return 0x01;
+}
@@ -30,6 +30,41 @@
 
 #include "../inc/Bumper_Switches.h"
 
+#ifdef OPT3001_INTERRUPT_MODE
+#include "../inc/OPT3001.h"
+#endif
+
+// Set by Bumper_Switches_Debounce_Init()
+static uint8_t Bumper_Debounce_Mode = 0;
+
+// Debounce window in microseconds
+static uint32_t Bumper_Debounce_us = 0;
+
+// Last debounced state of the switches in the format returned by Bumper_Read()
+static uint8_t Bumper_Stable_State = 0;
+
+// Time of the first edge of the change that is being debounced
+static uint32_t Bumper_Edge_Timestamp = 0;
+
+// Set by Bumper_Enable_Emergency_Stop()
+static volatile uint8_t Bumper_Emergency_Stop_Enabled = 0;
+
+// Worst-case latency from handler entry until the motors are stopped (MCLK cycles)
+static volatile uint32_t Bumper_Emergency_Stop_Latency = 0;
+
+// Set while Bumper_Emergency_Stop_Self_Test() is triggering the handler
+static volatile uint8_t Bumper_Self_Test_Active = 0;
+
+// Time when the handler stopped the motors during the self-test
+static volatile uint32_t Bumper_Self_Test_Stop_Time = 0;
+static volatile uint8_t Bumper_Self_Test_Done = 0;
+
+// Single-producer, single-consumer queue of debounced events
+static Bumper_Event Bumper_Event_Queue[BUMPER_EVENT_QUEUE_SIZE];
+static volatile uint8_t Bumper_Event_Head = 0;
+static volatile uint8_t Bumper_Event_Tail = 0;
+static volatile uint32_t Bumper_Event_Dropped = 0;
+
 void Bumper_Switches_Init(void(*task)(uint8_t))
 {
     // Store the user-defined task function for use during interrupt handling
@@ -37,33 +72,33 @@ void Bumper_Switches_Init(void(*task)(uint8_t))
 
     // Configure the following pins as GPIO pins: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by clearing the corresponding bits in the SEL0 and SEL1 registers
-    P4->SEL0 &= ~0xED;
-    P4->SEL1 &= ~0xED;
+    P4->SEL0 &= ~BUMPER_PIN_MASK;
+    P4->SEL1 &= ~BUMPER_PIN_MASK;
 
     // Set the direction of the following pins as input: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by clearing the corresponding bits in the DIR register
-    P4->DIR &= ~0xED;
+    P4->DIR &= ~BUMPER_PIN_MASK;
 
     // Enable pull-up resistors on the following pins: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by setting the corresponding bits in the REN register
-    P4->REN |= 0xED;
+    P4->REN |= BUMPER_PIN_MASK;
 
     // Ensure that the pins are pulled up: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by setting the corresponding bits in the OUT register
-    P4->OUT |= 0xED;
+    P4->OUT |= BUMPER_PIN_MASK;
 
     // Interrupt Edge Select: High-to-Low Transition
     // Configure the pins to use falling edge event triggers: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by setting the corresponding bits in the IES register
-    P4->IES |= 0xED;
+    P4->IES |= BUMPER_PIN_MASK;
 
     // Clear any existing interrupt flags on the following pins: P4.7, P4.6, P4.5, P4.3, P4.2, and P4.0
     // by clearing the corresponding bits in the IFG register
-    P4->IFG &= ~0xED;
+    P4->IFG &= ~BUMPER_PIN_MASK;
 
     // Enable interrupts on the following pins: P4.7 - P4.5, P4.3, P4.2, and P4.0
     // by setting the corresponding bits in the IE register
-    P4->IE |= 0xED;
+    P4->IE |= BUMPER_PIN_MASK;
 
     // Set the priority level of the interrupts (IRQ 38) to 0 (section 2.4.3.20)
     NVIC->IP[9] = (NVIC->IP[9] & 0xFF0FFFFF);
@@ -73,12 +108,187 @@ void Bumper_Switches_Init(void(*task)(uint8_t))
     NVIC->ISER[1] = 0x00000040;
 }
 
+void Bumper_Switches_Debounce_Init(void(*task)(uint8_t), uint32_t debounce_us)
+{
+    // Configure the pins and the PORT4 interrupt in the same way as the immediate mode
+    Bumper_Switches_Init(task);
+
+    // Disable the bumper pin interrupts while the debounce state is reset
+    P4->IE &= ~BUMPER_PIN_MASK;
+
+    // Enable the DWT cycle counter, which is used to timestamp the events
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x00000001;
+
+    Bumper_Debounce_us = debounce_us;
+    Bumper_Event_Head = 0;
+    Bumper_Event_Tail = 0;
+    Bumper_Event_Dropped = 0;
+    Bumper_Debounce_Mode = 1;
+
+    // Use TIMER32_2 as the one-shot debounce timer, with an interrupt priority level of 1
+    Timer32_OneShot_Timer_Init(TIMER32_ONESHOT_2, 1);
+
+    // Take the current level of the pins as the starting point and arm the edge detection
+    Bumper_Stable_State = Bumper_Read();
+
+    // Select a falling edge for released pins (high) and a rising edge for pressed pins (low)
+    P4->IES = (P4->IES & ~BUMPER_PIN_MASK) | (P4->IN & BUMPER_PIN_MASK);
+    P4->IFG &= ~BUMPER_PIN_MASK;
+    P4->IE |= BUMPER_PIN_MASK;
+}
+
+/**
+ * @brief Adds an event to the bumper event queue.
+ *
+ * @param event Pointer to the event to add.
+ *
+ * @return None
+ */
+static void Bumper_Post_Event(Bumper_Event *event)
+{
+    uint8_t next_head = (Bumper_Event_Head + 1) & (BUMPER_EVENT_QUEUE_SIZE - 1);
+
+    // Keep the oldest events if the queue is full
+    if (next_head == Bumper_Event_Tail)
+    {
+        Bumper_Event_Dropped++;
+        return;
+    }
+
+    Bumper_Event_Queue[Bumper_Event_Head] = *event;
+    Bumper_Event_Head = next_head;
+}
+
+static void Bumper_Debounce_Expired(void);
+
+/**
+ * @brief Starts the debounce window after the first edge of a change.
+ *
+ * The bumper pin interrupts stay disabled until the window expires.
+ *
+ * @return None
+ */
+static void Bumper_Start_Debounce(void)
+{
+    P4->IE &= ~BUMPER_PIN_MASK;
+    P4->IFG &= ~BUMPER_PIN_MASK;
+
+    Timer32_OneShot_Timer_Start(TIMER32_ONESHOT_2, &Bumper_Debounce_Expired, Bumper_Debounce_us);
+}
+
+uint8_t Bumper_Get_Event(Bumper_Event *event)
+{
+    if (Bumper_Event_Tail == Bumper_Event_Head)
+    {
+        return 0x00;
+    }
+
+    *event = Bumper_Event_Queue[Bumper_Event_Tail];
+    Bumper_Event_Tail = (Bumper_Event_Tail + 1) & (BUMPER_EVENT_QUEUE_SIZE - 1);
+
+    return 0x01;
+}
+
+void Bumper_Process_Events(void)
+{
+    Bumper_Event event;
+
+    while (Bumper_Get_Event(&event))
+    {
+        if (event.Pressed && Bumper_Task)
+        {
+            (*Bumper_Task)(event.State);
+        }
+    }
+}
+
+uint32_t Bumper_Dropped_Events(void)
+{
+    return Bumper_Event_Dropped;
+}
+
+void Bumper_Enable_Emergency_Stop(uint8_t enable)
+{
+    // Enable the DWT cycle counter, which is used to measure the latency
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x00000001;
+
+    Bumper_Emergency_Stop_Enabled = enable;
+}
+
+uint32_t Bumper_Emergency_Stop_Max_Latency(void)
+{
+    return Bumper_Emergency_Stop_Latency;
+}
+
+uint32_t Bumper_Emergency_Stop_Self_Test(uint16_t iterations)
+{
+    uint32_t worst_case = 0;
+    uint8_t was_stopped = Motor_Is_Emergency_Stopped();
+    uint8_t was_enabled = Bumper_Emergency_Stop_Enabled;
+    uint8_t saved_ie = P4->IE;
+    uint8_t saved_ies = P4->IES;
+
+    Bumper_Enable_Emergency_Stop(1);
+
+    // Only let P4.0 trigger the handler, and treat it as a contact (falling edge)
+    P4->IE &= ~BUMPER_PIN_MASK;
+    P4->IES |= 0x01;
+    P4->IFG &= ~BUMPER_PIN_MASK;
+    P4->IE |= 0x01;
+
+    Bumper_Self_Test_Active = 1;
+
+    for (uint16_t i = 0; i < iterations; i++)
+    {
+        Bumper_Self_Test_Done = 0;
+
+        // Setting the IFG flag in software requests the PORT4 interrupt
+        uint32_t start = DWT->CYCCNT;
+        P4->IFG |= 0x01;
+
+        // Give up after 1 ms in case interrupts are disabled
+        while ((Bumper_Self_Test_Done == 0) && ((DWT->CYCCNT - start) < (Clock_GetFreq() / 1000)));
+
+        if (Bumper_Self_Test_Done == 0)
+        {
+            worst_case = 0xFFFFFFFF;
+            break;
+        }
+
+        uint32_t latency = Bumper_Self_Test_Stop_Time - start;
+
+        if (latency > worst_case)
+        {
+            worst_case = latency;
+        }
+    }
+
+    Bumper_Self_Test_Active = 0;
+
+    // Restore the previous pin interrupt configuration
+    P4->IE &= ~BUMPER_PIN_MASK;
+    P4->IES = saved_ies;
+    P4->IFG &= ~BUMPER_PIN_MASK;
+    P4->IE = saved_ie;
+
+    Bumper_Emergency_Stop_Enabled = was_enabled;
+
+    if (!was_stopped)
+    {
+        Motor_Clear_Emergency_Stop();
+    }
+
+    return worst_case;
+}
+
 uint8_t Bumper_Read(void)
 {
     // Declare a local variable to store the input register value
     // Then, read the input register P4->IN and invert its value using the bitwise NOT operator (~).
     // This is done to account for the negative logic behavior of the bumper switches
-    uint32_t bumper_state = ~P4->IN;
+    uint32_t bumper_state = ~P4->IN & BUMPER_PIN_MASK;
 
     // Use bitwise operations to extract the relevant bits representing the switch states.
     // - ((bumper_state & 0xE0) >> 2): Extract bits 7, 6, and 5, and right-shift them by 2 to align them to bits 5, 4, and 3.
@@ -98,13 +308,131 @@ uint8_t Bumper_Read(void)
  *
  * @note This function does not handle critical section/race conditions.
  *
+ * @note If the emergency stop is enabled, the motors are stopped before anything else is done.
+ *
+ * @note Once Bumper_Switches_Debounce_Init() has been called, the handler only starts the debounce window
+ *       and the user-defined task is called from the main loop by Bumper_Process_Events().
+ *
+ * @note When OPT3001_INTERRUPT_MODE is defined, P4.2 is the INT pin of the OPT3001, so its edges are passed
+ *       to OPT3001_Interrupt_Handler() and the remaining bumper pins (BUMPER_PIN_MASK) are handled as usual.
+ *
  * @return None
  */
 void PORT4_IRQHandler(void)
 {
+#ifdef OPT3001_INTERRUPT_MODE
+    // Pass the edges of the OPT3001 INT pin (P4.2) to the OPT3001 driver
+    if (P4->IFG & P4->IE & 0x04)
+    {
+        OPT3001_Interrupt_Handler();
+    }
+
+    // The flags of the other pins are set even when their interrupt is disabled, so only handle the enabled ones
+    if ((P4->IFG & P4->IE & BUMPER_PIN_MASK) == 0)
+    {
+        return;
+    }
+#endif
+
+    // Stop the motors if any pending flag belongs to a falling edge (a new contact)
+    if (Bumper_Emergency_Stop_Enabled && (P4->IFG & P4->IES & BUMPER_PIN_MASK))
+    {
+        uint32_t entry = DWT->CYCCNT;
+
+        Motor_Emergency_Stop();
+
+        uint32_t stop = DWT->CYCCNT;
+
+        if (Bumper_Self_Test_Active)
+        {
+            Bumper_Self_Test_Stop_Time = stop;
+            Bumper_Self_Test_Done = 1;
+            P4->IFG &= ~BUMPER_PIN_MASK;
+            return;
+        }
+
+        uint32_t latency = (stop - entry) + BUMPER_EXCEPTION_ENTRY_CYCLES;
+
+        if (latency > Bumper_Emergency_Stop_Latency)
+        {
+            Bumper_Emergency_Stop_Latency = latency;
+        }
+    }
+
+    if (Bumper_Debounce_Mode)
+    {
+        // Record the time of the first edge and ignore the bounces that follow it
+        Bumper_Edge_Timestamp = DWT->CYCCNT;
+        Bumper_Start_Debounce();
+        return;
+    }
+
     // Clear the interrupt flags for P4.7 - P4.5, P4.3, P4.2, and P4.0
-    P4->IFG &= ~0xED;
+    P4->IFG &= ~BUMPER_PIN_MASK;
 
     // Execute the user-defined task
-    (*Bumper_Task)(Bumper_Read());
+    if (Bumper_Task)
+    {
+        (*Bumper_Task)(Bumper_Read());
+    }
+}
+
+/**
+ * @brief Handles the end of the bumper debounce window.
+ *
+ * This function is called by the Timer32_OneShot driver from the TIMER32_2 interrupt. It samples the
+ * Bumper Switches once, queues an event if the debounced state has changed, and re-arms the bumper pin
+ * interrupts for the opposite edge of each pin.
+ *
+ * The pin interrupts are disabled during the window, so a contact that starts inside the window is
+ * only seen here. If the emergency stop is enabled, such a contact stops the motors before its event is queued.
+ *
+ * @return None
+ */
+static void Bumper_Debounce_Expired(void)
+{
+    // Sample the pins once so that the event and the edge selection agree
+    uint8_t level = P4->IN & BUMPER_PIN_MASK;
+    uint8_t pressed = ~level & BUMPER_PIN_MASK;
+    uint8_t state = (((pressed & 0xE0) >> 2) | ((pressed & 0x0C) >> 1) | (pressed & 0x01));
+
+    if (state != Bumper_Stable_State)
+    {
+        if (Bumper_Emergency_Stop_Enabled && (state & ~Bumper_Stable_State))
+        {
+            Motor_Emergency_Stop();
+        }
+
+        Bumper_Event event;
+        event.State = state;
+        event.Pressed = state & ~Bumper_Stable_State;
+        event.Released = Bumper_Stable_State & ~state;
+        event.Timestamp = Bumper_Edge_Timestamp;
+
+        Bumper_Post_Event(&event);
+        Bumper_Stable_State = state;
+    }
+
+    // Select a falling edge for released pins (high) and a rising edge for pressed pins (low)
+    // Changing the IES register can set the IFG flags, so clear them afterwards
+    P4->IES = (P4->IES & ~BUMPER_PIN_MASK) | level;
+    P4->IFG &= ~BUMPER_PIN_MASK;
+
+    // If a pin changed while it was being re-armed, its edge was missed, so debounce it again
+    uint8_t current_level = P4->IN & BUMPER_PIN_MASK;
+
+    if (current_level != level)
+    {
+        // A pin that went low is a new contact
+        if (Bumper_Emergency_Stop_Enabled && (level & ~current_level))
+        {
+            Motor_Emergency_Stop();
+        }
+
+        Bumper_Edge_Timestamp = DWT->CYCCNT;
+        Bumper_Start_Debounce();
+        return;
+    }
+
+    P4->IE |= BUMPER_PIN_MASK;
 }
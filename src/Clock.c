@@ -44,6 +44,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Clock.h"
+#include "../inc/HAL.h"
 
 uint32_t ClockFrequency = 3000000; // cycles/second
 //static uint32_t SubsystemFrequency = 3000000; // cycles/second
@@ -145,8 +146,12 @@ uint32_t Clock_GetFreq(void){
 // ulCount=8000 => 1ms = (8000 loops)*(6 cycles/loop)*(20.83 ns/cycle)
   //Code Composer Studio Code
 void delay(unsigned long ulCount){
+#ifdef HAL_HOST
+  HAL_Host_Advance(6*ulCount);  // the host simulation only advances its cycle counter
+#else
   __asm (  "pdloop:  subs    r0, #1\n"
       "    bne    pdloop\n");
+#endif
 }
 
 // ------------Clock_Delay1us------------
@@ -14,6 +14,7 @@
  */
 
 #include "../inc/EUSCI_A0_UART.h"
+#include "../inc/HAL.h"
 
 void EUSCI_A0_UART_Init()
 {
@@ -49,16 +50,16 @@ void EUSCI_A0_UART_Init()
 
 char EUSCI_A0_UART_InChar()
 {
-    while((EUSCI_A0->IFG&0x01) == 0);
+    HAL_WAIT_WHILE((EUSCI_A0->IFG&0x01) == 0);
 
-    return((char)(EUSCI_A0->RXBUF));
+    return((char)(HAL_EUSCI_READ_RXBUF(EUSCI_A0)));
 }
 
 void EUSCI_A0_UART_OutChar(char letter)
 {
-    while((EUSCI_A0->IFG&0x02) == 0);
+    HAL_WAIT_WHILE((EUSCI_A0->IFG&0x02) == 0);
 
-    EUSCI_A0->TXBUF = letter;
+    HAL_EUSCI_WRITE_TXBUF(EUSCI_A0, letter);
 }
 
 void EUSCI_A0_UART_InString(char *bufPt, uint16_t max)
@@ -15,6 +15,8 @@
  */
 
 #include "../inc/EUSCI_A3_UART.h"
+#include "../inc/HAL.h"
+#include <stdio.h>
 
 void EUSCI_A3_UART_Init()
 {
@@ -86,11 +88,11 @@ uint8_t EUSCI_A3_UART_InChar()
     // in the IFG register and wait if the flag is not set
     // If the UCRXIFG is set, then the Receive Buffer (UCAxRXBUF) has
     // received a complete character
-    while((EUSCI_A3->IFG & 0x01) == 0);
+    HAL_WAIT_WHILE((EUSCI_A3->IFG & 0x01) == 0);
 
     // Return the data from the Receive Buffer (UCAxRXBUF)
     // Reading the UCAxRXBUF will reset the UCRXIFG flag
-    return EUSCI_A3->RXBUF;
+    return HAL_EUSCI_READ_RXBUF(EUSCI_A3);
 }
 
 void EUSCI_A3_UART_OutChar(uint8_t data)
@@ -98,11 +100,11 @@ void EUSCI_A3_UART_OutChar(uint8_t data)
     // Check the Transmit Interrupt flag (UCTXIFG, Bit 1)
     // in the IFG register and wait if the flag is not set
     // If the UCTXIFG is set, then the Transmit Buffer (UCAxTXBUF) is empty
-    while((EUSCI_A3->IFG & 0x02) == 0);
+    HAL_WAIT_WHILE((EUSCI_A3->IFG & 0x02) == 0);
 
     // Write the data to the Transmit Buffer (UCAxTXBUF)
     // Writing to the UCAxTXBUF will clear the UCTXIFG flag
-    EUSCI_A3->TXBUF = data;
+    HAL_EUSCI_WRITE_TXBUF(EUSCI_A3, data);
 }
 
 uint8_t EUSCI_A3_UART_Transmit_Data()
@@ -17,7 +17,9 @@
  *
  */
 
+#include <stddef.h>
 #include "../inc/EUSCI_B1_I2C.h"
+#include "../inc/HAL.h"
 
 void EUSCI_B1_I2C_Init()
 {
@@ -97,7 +99,7 @@ void EUSCI_B1_I2C_Send_A_Byte(uint8_t slave_address, uint8_t data)
 {
     // Wait until the EUSCI_B1 module is not busy by checking the
     // UCBBUSY bit (Bit 4) in the UCBxSTATw register
-    while((EUSCI_B1->STATW & 0x0010) != 0);
+    HAL_WAIT_WHILE((EUSCI_B1->STATW & 0x0010) != 0);
 
     // Assign the slave device's address to the UCBxI2CSA register
     EUSCI_B1->I2CSA = slave_address;
@@ -109,15 +111,15 @@ void EUSCI_B1_I2C_Send_A_Byte(uint8_t slave_address, uint8_t data)
 
     // Wait until the transmit interrupt flag is not pending by checking the
     // UCTXIFG0 bit (Bit 1) in the UCBxIFG register
-    while((EUSCI_B1->IFG & 0x0002) == 0);
+    HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0002) == 0);
 
     // Store the 8-bit data in the Transmit Buffer by writing the data
     // to the UCBxTXBUF register
-    EUSCI_B1->TXBUF = data;
+    HAL_EUSCI_WRITE_TXBUF(EUSCI_B1, data);
 
     // Wait until the transmit interrupt flag is not pending by checking the
     // UCTXIFG0 bit (Bit 1) in the UCBxIFG register
-    while((EUSCI_B1->IFG & 0x0002) == 0);
+    HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0002) == 0);
 
     // Generate the STOP condition by setting the
     // UCTXSTP bit (Bit 2) in the UCBxCTLW0 register
@@ -132,7 +134,7 @@ void EUSCI_B1_I2C_Send_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffe
 {
     // Wait until the EUSCI_B1 module is not busy by checking the
     // UCBBUSY bit (Bit 4) in the UCBxSTATw register
-    while((EUSCI_B1->STATW & 0x0010) != 0);
+    HAL_WAIT_WHILE((EUSCI_B1->STATW & 0x0010) != 0);
 
     // Assign the slave device's address to the UCBxI2CSA register
     EUSCI_B1->I2CSA = slave_address;
@@ -147,16 +149,16 @@ void EUSCI_B1_I2C_Send_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffe
     {
         // Wait until the transmit interrupt flag is not pending by checking the
         // UCTXIFG0 bit (Bit 1) in the UCBxIFG register
-        while((EUSCI_B1->IFG & 0x0002) == 0);
+        HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0002) == 0);
 
         // Store the 8-bit data in the Transmit Buffer by writing the data
         // to the UCBxTXBUF register
-        EUSCI_B1->TXBUF = data_buffer[i];
+        HAL_EUSCI_WRITE_TXBUF(EUSCI_B1, data_buffer[i]);
     }
 
     // Wait until the transmit interrupt flag is not pending by checking the
     // UCTXIFG0 bit (Bit 1) in the UCBxIFG register
-    while((EUSCI_B1->IFG & 0x0002) == 0);
+    HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0002) == 0);
 
     // Generate the STOP condition by setting the
     // UCTXSTP bit (Bit 2) in the UCBxCTLW0 register
@@ -171,7 +173,7 @@ uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address)
 {
     // Wait until the EUSCI_B1 module is not busy by checking the
     // UCBBUSY bit (Bit 4) in the UCBxSTATw register
-    while((EUSCI_B1->STATW & 0x0010) != 0);
+    HAL_WAIT_WHILE((EUSCI_B1->STATW & 0x0010) != 0);
 
     // Hold the EUSCI_B1 module in reset mode by setting the
     // UCSWRST bit (Bit 0) in the UCBxCTLW0 register
@@ -195,10 +197,10 @@ uint8_t EUSCI_B1_I2C_Receive_A_Byte(uint8_t slave_address)
 
     // Wait until the receive interrupt flag is not pending by checking the
     // UCRXIFG0 bit (Bit 0) in the UCBxIFG register
-    while((EUSCI_B1->IFG & 0x0001) == 0);
+    HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0001) == 0);
 
     // Return the received data from the Receive Buffer and ensure that it has a type of uint8_t
-    return ((uint8_t)(EUSCI_B1->RXBUF));
+    return ((uint8_t)(HAL_EUSCI_READ_RXBUF(EUSCI_B1)));
 }
 
 void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_buffer, uint16_t packet_length)
@@ -221,13 +223,514 @@ void EUSCI_B1_I2C_Receive_Multiple_Bytes(uint8_t slave_address, uint8_t *data_bu
 
         // Wait until the receive interrupt flag is not pending by checking the
         // UCRXIFG0 bit (Bit 0) in the UCBxIFG register
-        while((EUSCI_B1->IFG & 0x0001) == 0);
+        HAL_WAIT_WHILE((EUSCI_B1->IFG & 0x0001) == 0);
 
         // Transfer the received data from the Receive Buffer and write it to data_buffer
-        data_buffer[i] = EUSCI_B1->RXBUF;
+        data_buffer[i] = HAL_EUSCI_READ_RXBUF(EUSCI_B1);
     }
 
     // Wait until the STOP condition is transmitted by checking the status of the
     // UCTXSTP bit (Bit 2) in the UCBxCTLW0 register
-    while((EUSCI_B1->CTLW0 & 0x0004) != 0);
+    HAL_WAIT_WHILE((EUSCI_B1->CTLW0 & 0x0004) != 0);
+}
+
+// Transactions waiting to be started by the interrupt-driven implementation
+static EUSCI_B1_I2C_Transaction *EUSCI_B1_I2C_Queue[EUSCI_B1_I2C_QUEUE_SIZE];
+
+// Index of the oldest transaction in the queue
+static volatile uint8_t EUSCI_B1_I2C_Queue_Head = 0;
+
+// Number of transactions in the queue
+static volatile uint8_t EUSCI_B1_I2C_Queue_Count = 0;
+
+// Transaction that currently owns the bus, or NULL if the bus is idle
+static EUSCI_B1_I2C_Transaction * volatile EUSCI_B1_I2C_Active = NULL;
+
+// Index of the next byte to transmit or receive in the active transaction
+static volatile uint16_t EUSCI_B1_I2C_Index = 0;
+
+// Number of EUSCI_B1_I2C_Timeout_Tick() calls left before the active transaction is aborted
+static volatile uint16_t EUSCI_B1_I2C_Ticks_Remaining = 0;
+
+// Result reported when the active transaction completes
+static volatile EUSCI_B1_I2C_Status EUSCI_B1_I2C_Result = EUSCI_B1_I2C_SUCCESS;
+
+// Set when the write phase of a transaction with a single-byte read ends with a STOP condition
+// and the read phase must be started on the STOP interrupt
+static volatile uint8_t EUSCI_B1_I2C_Read_Pending = 0;
+
+// Set while the automatic STOP condition is enabled for a single-byte read
+static volatile uint8_t EUSCI_B1_I2C_Auto_Stop = 0;
+
+// Interrupts that remain enabled while the interrupt-driven implementation is in use:
+// - Arbitration Lost Interrupt (UCALIE, Bit 4)
+// - STOP Condition Interrupt (UCSTPIE, Bit 3)
+// - Not-Acknowledge Interrupt (UCNACKIE, Bit 5)
+#define EUSCI_B1_I2C_STATUS_INTERRUPTS 0x0038
+
+// Transmit Interrupt 0 (UCTXIE0, Bit 1) and Receive Interrupt 0 (UCRXIE0, Bit 0)
+#define EUSCI_B1_I2C_DATA_INTERRUPTS 0x0003
+
+/**
+ * @brief Enables or disables the automatic STOP condition after a number of bytes.
+ *
+ * The UCBxCTLW1 and UCBxTBCNT registers can only be written while the module is held in reset,
+ * so this function must only be called while the bus is idle.
+ *
+ * @param byte_count Number of bytes after which the STOP condition is generated, or 0 to disable it.
+ *
+ * @return None
+ */
+static void EUSCI_B1_I2C_Set_Auto_Stop(uint8_t byte_count)
+{
+    // Hold the EUSCI_B1 module in reset by setting the UCSWRST bit (Bit 0) in the UCBxCTLW0 register
+    EUSCI_B1->CTLW0 |= 0x0001;
+
+    // Set UCASTPx (Bits 3 to 2) in the UCBxCTLW1 register to 10b to generate the STOP condition
+    // automatically once the byte counter reaches UCBxTBCNT, or clear them to disable it
+    EUSCI_B1->CTLW1 = (EUSCI_B1->CTLW1 & ~0x000C) | ((byte_count) ? 0x0008 : 0x0000);
+    EUSCI_B1->TBCNT = byte_count;
+
+    // Release the EUSCI_B1 module from reset. This clears the UCBxIE register, so restore the status interrupts
+    EUSCI_B1->CTLW0 &= ~0x0001;
+    EUSCI_B1->IE = EUSCI_B1_I2C_STATUS_INTERRUPTS;
+
+    EUSCI_B1_I2C_Auto_Stop = (byte_count) ? 0x01 : 0x00;
+}
+
+/**
+ * @brief Begins the read phase of the active transaction.
+ *
+ * @note A single-byte read must be started while the bus is idle, since it uses the automatic STOP condition.
+ *
+ * @return None
+ */
+static void EUSCI_B1_I2C_Start_Read(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = EUSCI_B1_I2C_Active;
+
+    EUSCI_B1_I2C_Index = 0;
+
+    // For a single-byte read, the STOP condition must be requested while the byte is being received.
+    // Let the byte counter generate it instead of waiting for the address to be acknowledged
+    if (transaction->Read_Length == 1)
+    {
+        EUSCI_B1_I2C_Set_Auto_Stop(1);
+    }
+
+    // Enable the Receive Interrupt (UCRXIE0, Bit 0) in the UCBxIE register
+    EUSCI_B1->IE |= 0x0001;
+
+    // Clear the UCTR bit (Bit 4) in the UCBxCTLW0 register to configure the EUSCI_B1 module
+    // in master receiver mode. Then, set the UCTXSTT bit (Bit 1) to generate the (repeated) START condition
+    EUSCI_B1->CTLW0 = (EUSCI_B1->CTLW0 & ~0x0010) | 0x0002;
+}
+
+/**
+ * @brief Starts a transaction on the idle bus.
+ *
+ * @param transaction Pointer to the transaction descriptor.
+ *
+ * @return None
+ */
+static void EUSCI_B1_I2C_Start(EUSCI_B1_I2C_Transaction *transaction)
+{
+    EUSCI_B1_I2C_Active = transaction;
+    EUSCI_B1_I2C_Index = 0;
+    EUSCI_B1_I2C_Result = EUSCI_B1_I2C_SUCCESS;
+    EUSCI_B1_I2C_Read_Pending = 0;
+    EUSCI_B1_I2C_Ticks_Remaining = (transaction->Timeout) ? transaction->Timeout : EUSCI_B1_I2C_DEFAULT_TIMEOUT;
+
+    // Assign the slave device's address to the UCBxI2CSA register
+    EUSCI_B1->I2CSA = transaction->Slave_Address;
+
+    if (transaction->Type == EUSCI_B1_I2C_READ)
+    {
+        EUSCI_B1_I2C_Start_Read();
+    }
+    else
+    {
+        // Set the UCTR bit (Bit 4) in the UCBxCTLW0 register to configure the EUSCI_B1 module
+        // in master transmitter mode. Then, clear the UCTXSTP bit (Bit 2) to not generate the STOP condition
+        // Lastly, set the UCTXSTT bit (Bit 1) to generate the START condition
+        EUSCI_B1->CTLW0 = (EUSCI_B1->CTLW0 & ~0x0004) | 0x0012;
+
+        // Enable the Transmit Interrupt (UCTXIE0, Bit 1) in the UCBxIE register
+        EUSCI_B1->IE |= 0x0002;
+    }
+}
+
+/**
+ * @brief Completes the active transaction, calls its callback, and starts the next queued transaction.
+ *
+ * @note Must be called with the EUSCIB1 interrupt masked (i.e. from the ISR or a critical section).
+ *
+ * @return None
+ */
+static void EUSCI_B1_I2C_Complete(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = EUSCI_B1_I2C_Active;
+
+    // Disable the TX and RX interrupts until the next transaction needs them
+    EUSCI_B1->IE &= ~EUSCI_B1_I2C_DATA_INTERRUPTS;
+
+    // The bus is idle, so the automatic STOP condition of a single-byte read can be disabled again
+    if (EUSCI_B1_I2C_Auto_Stop)
+    {
+        EUSCI_B1_I2C_Set_Auto_Stop(0);
+    }
+
+    EUSCI_B1_I2C_Active = NULL;
+    EUSCI_B1_I2C_Read_Pending = 0;
+
+    if (transaction != NULL)
+    {
+        transaction->Status = EUSCI_B1_I2C_Result;
+
+        if (transaction->Callback)
+        {
+            (*transaction->Callback)(transaction);
+        }
+    }
+
+    // The callback may have already started a new transaction
+    if ((EUSCI_B1_I2C_Active == NULL) && (EUSCI_B1_I2C_Queue_Count > 0))
+    {
+        EUSCI_B1_I2C_Transaction *next = EUSCI_B1_I2C_Queue[EUSCI_B1_I2C_Queue_Head];
+        EUSCI_B1_I2C_Queue_Head = (EUSCI_B1_I2C_Queue_Head + 1) % EUSCI_B1_I2C_QUEUE_SIZE;
+        EUSCI_B1_I2C_Queue_Count--;
+        EUSCI_B1_I2C_Start(next);
+    }
+}
+
+void EUSCI_B1_I2C_Async_Init()
+{
+    EUSCI_B1_I2C_Queue_Head = 0;
+    EUSCI_B1_I2C_Queue_Count = 0;
+    EUSCI_B1_I2C_Active = NULL;
+
+    // Clear any pending interrupt flags by clearing Bits 14 to 0 in the UCBxIFG register
+    EUSCI_B1->IFG &= ~0x7FFF;
+
+    // Enable the STOP condition, NACK, and arbitration lost interrupts in the UCBxIE register
+    EUSCI_B1->IE = EUSCI_B1_I2C_STATUS_INTERRUPTS;
+
+    // Set interrupt priority level to 3 using the IPR5 register of NVIC
+    // EUSCI_B1 has an IRQ number of 21
+    NVIC->IP[5] = (NVIC->IP[5] & 0xFFFF00FF) | 0x00006000;
+
+    // Enable Interrupt 21 in NVIC by setting Bit 21 of the ISER register
+    NVIC->ISER[0] |= 0x00200000;
+}
+
+uint8_t EUSCI_B1_I2C_Submit(EUSCI_B1_I2C_Transaction *transaction)
+{
+    uint8_t needs_write = (transaction->Type != EUSCI_B1_I2C_READ);
+    uint8_t needs_read = (transaction->Type != EUSCI_B1_I2C_WRITE);
+
+    // Reject descriptors whose buffers do not match the transaction type
+    if (needs_write && ((transaction->Write_Buffer == NULL) || (transaction->Write_Length == 0)))
+    {
+        return 0x00;
+    }
+
+    if (needs_read && ((transaction->Read_Buffer == NULL) || (transaction->Read_Length == 0)))
+    {
+        return 0x00;
+    }
+
+    uint8_t accepted = 0x00;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (transaction->Status != EUSCI_B1_I2C_PENDING)
+    {
+        if (EUSCI_B1_I2C_Active == NULL)
+        {
+            transaction->Status = EUSCI_B1_I2C_PENDING;
+            EUSCI_B1_I2C_Start(transaction);
+            accepted = 0x01;
+        }
+        else if (EUSCI_B1_I2C_Queue_Count < EUSCI_B1_I2C_QUEUE_SIZE)
+        {
+            uint8_t tail = (EUSCI_B1_I2C_Queue_Head + EUSCI_B1_I2C_Queue_Count) % EUSCI_B1_I2C_QUEUE_SIZE;
+            transaction->Status = EUSCI_B1_I2C_PENDING;
+            EUSCI_B1_I2C_Queue[tail] = transaction;
+            EUSCI_B1_I2C_Queue_Count++;
+            accepted = 0x01;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    return accepted;
+}
+
+uint8_t EUSCI_B1_I2C_Busy()
+{
+    return ((EUSCI_B1_I2C_Active != NULL) || (EUSCI_B1_I2C_Queue_Count > 0)) ? 0x01 : 0x00;
+}
+
+void EUSCI_B1_I2C_Timeout_Tick()
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((EUSCI_B1_I2C_Active != NULL) && (--EUSCI_B1_I2C_Ticks_Remaining == 0))
+    {
+        // Reset the EUSCI_B1 module to release the bus by toggling the
+        // UCSWRST bit (Bit 0) in the UCBxCTLW0 register
+        EUSCI_B1->CTLW0 |= 0x0001;
+        EUSCI_B1->CTLW0 &= ~0x0001;
+
+        // Resetting the module clears the UCBxIE register, so restore the status interrupts
+        EUSCI_B1->IE = EUSCI_B1_I2C_STATUS_INTERRUPTS;
+
+        EUSCI_B1_I2C_Result = EUSCI_B1_I2C_TIMEOUT;
+        EUSCI_B1_I2C_Complete();
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Interrupt handler for the EUSCI_B1 module.
+ *
+ * This function advances the active transaction of the interrupt-driven implementation.
+ * Reading the UCBxIV register returns the highest-priority pending interrupt and clears its flag.
+ *
+ * @return None
+ */
+void EUSCIB1_IRQHandler(void)
+{
+    EUSCI_B1_I2C_Transaction *transaction = EUSCI_B1_I2C_Active;
+
+    switch (EUSCI_B1->IV)
+    {
+        // Arbitration lost (UCALIFG): the module has switched to slave mode, so no STOP condition follows
+        case 0x02:
+        {
+            // Return to master mode by setting the UCMST bit (Bit 11) in the UCBxCTLW0 register
+            EUSCI_B1->CTLW0 |= 0x0800;
+            EUSCI_B1_I2C_Result = EUSCI_B1_I2C_ARBITRATION;
+            EUSCI_B1_I2C_Complete();
+            break;
+        }
+
+        // Not-acknowledge received (UCNACKIFG): release the bus and complete on the STOP interrupt
+        case 0x04:
+        {
+            EUSCI_B1->IE &= ~EUSCI_B1_I2C_DATA_INTERRUPTS;
+            EUSCI_B1_I2C_Result = EUSCI_B1_I2C_NACK;
+            EUSCI_B1->CTLW0 |= 0x0004;
+            break;
+        }
+
+        // STOP condition sent (UCSTPIFG): the transaction is complete, unless its single-byte read is still pending
+        case 0x08:
+        {
+            if (EUSCI_B1_I2C_Read_Pending && (EUSCI_B1_I2C_Result == EUSCI_B1_I2C_SUCCESS) && (transaction != NULL))
+            {
+                EUSCI_B1_I2C_Read_Pending = 0;
+                EUSCI_B1_I2C_Start_Read();
+            }
+            else
+            {
+                EUSCI_B1_I2C_Complete();
+            }
+            break;
+        }
+
+        // Data received (UCRXIFG0)
+        case 0x16:
+        {
+            uint8_t data = HAL_EUSCI_READ_RXBUF(EUSCI_B1);
+
+            if (transaction == NULL)
+            {
+                break;
+            }
+
+            if (EUSCI_B1_I2C_Index < transaction->Read_Length)
+            {
+                transaction->Read_Buffer[EUSCI_B1_I2C_Index] = data;
+                EUSCI_B1_I2C_Index++;
+            }
+
+            // Request the STOP condition while the last byte is being received
+            if ((transaction->Read_Length > 1) && (EUSCI_B1_I2C_Index == (transaction->Read_Length - 1)))
+            {
+                EUSCI_B1->CTLW0 |= 0x0004;
+            }
+
+            // All bytes have been received, so wait for the STOP interrupt
+            if (EUSCI_B1_I2C_Index >= transaction->Read_Length)
+            {
+                EUSCI_B1->IE &= ~0x0001;
+            }
+            break;
+        }
+
+        // Transmit buffer empty (UCTXIFG0)
+        case 0x18:
+        {
+            if (transaction == NULL)
+            {
+                EUSCI_B1->IE &= ~0x0002;
+                break;
+            }
+
+            if (EUSCI_B1_I2C_Index < transaction->Write_Length)
+            {
+                HAL_EUSCI_WRITE_TXBUF(EUSCI_B1, transaction->Write_Buffer[EUSCI_B1_I2C_Index]);
+                EUSCI_B1_I2C_Index++;
+            }
+            else
+            {
+                // The last byte is being shifted out
+                EUSCI_B1->IE &= ~0x0002;
+
+                if ((transaction->Type == EUSCI_B1_I2C_WRITE_READ) && (transaction->Read_Length == 1))
+                {
+                    // The automatic STOP condition can only be enabled while the bus is idle,
+                    // so end the write phase and start the read on the STOP interrupt
+                    EUSCI_B1_I2C_Read_Pending = 1;
+                    EUSCI_B1->CTLW0 |= 0x0004;
+                }
+                else if (transaction->Type == EUSCI_B1_I2C_WRITE_READ)
+                {
+                    EUSCI_B1_I2C_Start_Read();
+                }
+                else
+                {
+                    EUSCI_B1->CTLW0 |= 0x0004;
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Checks whether a register address is held by the cache.
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @return 0x01 if the register is cached. Otherwise, returns 0x00.
+ */
+static uint8_t EUSCI_B1_I2C_Cache_Contains(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address)
+{
+    return (register_address < cache->Register_Count) ? 0x01 : 0x00;
+}
+
+/**
+ * @brief Checks whether the cached value of a register matches the device.
+ *
+ * @param cache Pointer to the cache.
+ *
+ * @param register_address The address of the register.
+ *
+ * @return 0x01 if the register is cached and valid. Otherwise, returns 0x00.
+ */
+static uint8_t EUSCI_B1_I2C_Cache_Is_Valid(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address)
+{
+    if (!EUSCI_B1_I2C_Cache_Contains(cache, register_address))
+    {
+        return 0x00;
+    }
+
+    return (cache->Valid & ((uint32_t)1 << register_address)) ? 0x01 : 0x00;
+}
+
+void EUSCI_B1_I2C_Cache_Init(EUSCI_B1_I2C_Register_Cache *cache, uint8_t slave_address,
+                             uint16_t *values, const uint16_t *volatile_masks, uint8_t register_count)
+{
+    if (register_count > EUSCI_B1_I2C_CACHE_MAX_REGISTERS)
+    {
+        register_count = EUSCI_B1_I2C_CACHE_MAX_REGISTERS;
+    }
+
+    cache->Slave_Address = slave_address;
+    cache->Register_Count = register_count;
+    cache->Values = values;
+    cache->Volatile_Masks = volatile_masks;
+    cache->Valid = 0;
+}
+
+uint8_t EUSCI_B1_I2C_Cache_Write(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t value)
+{
+    // Skip the write if the device already holds the value (volatile bits cannot be compared)
+    if (EUSCI_B1_I2C_Cache_Is_Valid(cache, register_address))
+    {
+        uint16_t stable_mask = ~cache->Volatile_Masks[register_address];
+
+        if (((cache->Values[register_address] ^ value) & stable_mask) == 0)
+        {
+            return 0x00;
+        }
+    }
+
+    uint8_t buffer[] =
+    {
+        register_address,
+        (value >> 8) & 0xFF,
+        value & 0xFF,
+    };
+
+    EUSCI_B1_I2C_Send_Multiple_Bytes(cache->Slave_Address, buffer, sizeof(buffer));
+
+    EUSCI_B1_I2C_Cache_Update(cache, register_address, value);
+
+    return 0x01;
+}
+
+uint16_t EUSCI_B1_I2C_Cache_Read(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t mask)
+{
+    // Serve the read from the cache if none of the requested bits can change on their own
+    if (EUSCI_B1_I2C_Cache_Is_Valid(cache, register_address) &&
+        ((mask & cache->Volatile_Masks[register_address]) == 0))
+    {
+        return cache->Values[register_address] & mask;
+    }
+
+    uint8_t buffer[2];
+
+    // Set the register pointer and then read the register
+    EUSCI_B1_I2C_Send_Multiple_Bytes(cache->Slave_Address, &register_address, 1);
+    EUSCI_B1_I2C_Receive_Multiple_Bytes(cache->Slave_Address, buffer, 2);
+
+    uint16_t value = buffer[1] + ((uint16_t)buffer[0] << 8);
+
+    EUSCI_B1_I2C_Cache_Update(cache, register_address, value);
+
+    return value & mask;
+}
+
+uint8_t EUSCI_B1_I2C_Cache_Modify(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t mask, uint16_t value)
+{
+    // Fetch the current value once if it is not known yet
+    uint16_t current = EUSCI_B1_I2C_Cache_Is_Valid(cache, register_address)
+                       ? cache->Values[register_address]
+                       : EUSCI_B1_I2C_Cache_Read(cache, register_address, 0xFFFF);
+
+    return EUSCI_B1_I2C_Cache_Write(cache, register_address, (current & ~mask) | (value & mask));
+}
+
+void EUSCI_B1_I2C_Cache_Update(EUSCI_B1_I2C_Register_Cache *cache, uint8_t register_address, uint16_t value)
+{
+    if (EUSCI_B1_I2C_Cache_Contains(cache, register_address))
+    {
+        cache->Values[register_address] = value;
+        cache->Valid |= ((uint32_t)1 << register_address);
+    }
+}
+
+void EUSCI_B1_I2C_Cache_Invalidate(EUSCI_B1_I2C_Register_Cache *cache)
+{
+    cache->Valid = 0;
 }
@@ -111,11 +111,11 @@ uint8_t Get_Buttons_Status()
 
 void PMOD_8LD_Init()
 {
-    P9->SEL0 &= ~0xFF;
-    P9->SEL1 &= ~0xFF;
+    P9->SEL0 = 0x00;
+    P9->SEL1 = 0x00;
     P9->DS |= 0xFF;
     P9->DIR |= 0xFF;
-    P9->OUT &= ~0xFF;
+    P9->OUT = 0x00;
 }
 
 uint8_t PMOD_8LD_Output(uint8_t led_value)
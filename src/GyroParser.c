@@ -4,7 +4,7 @@
  *
  * This file implements functions to parse gyroscope data from BLE packets,
  * validate the packet structure and checksum (CRC), and extract floating-point
- * values for further processing.
+ * values for further processing, either as floats or as Q16.16 fixed point.
  *
  * @author Nainika Saha
  */
@@ -16,46 +16,91 @@
 #include "inc/GyroParser.h" // Include the header for function declarations
 
 // Function prototypes
-void ParseBLEPacket(uint8_t *buffer);
-bool ValidateBLEPacket(uint8_t *buffer);
+bool ParseBLEPacket(uint8_t *buffer, uint16_t length);
+bool ParseGyroPacket(uint8_t *buffer, uint16_t length, Gyro_Sample *sample);
+bool ValidateBLEPacket(uint8_t *buffer, uint16_t length);
 bool ValidateCRC(uint8_t *buffer);
 float ExtractFloat(uint8_t *buffer, uint8_t offset);
+int32_t ExtractQ16(uint8_t *buffer, uint8_t offset);
+
+/**
+ * @brief Formats a Q16.16 value with two decimals, like the `%.2f` format, using integer operations.
+ *
+ * @param text Buffer of at least 12 characters for the formatted value.
+ * @param value Value in Q16.16.
+ * @return The formatted value.
+ */
+static char *FormatQ16(char *text, int32_t value) {
+    uint32_t magnitude = (value < 0) ? (uint32_t)(-value) : (uint32_t)value;
+
+    // Round to hundredths
+    uint32_t hundredths = (uint32_t)((((uint64_t)magnitude * 100) + (GYRO_Q16_ONE / 2)) >> GYRO_Q16_SHIFT);
+
+    sprintf(text, "%s%u.%02u", (value < 0) ? "-" : "", (unsigned)(hundredths / 100), (unsigned)(hundredths % 100));
+    return text;
+}
 
 /**
  * @brief Parses a BLE packet to process gyroscope data.
  *
  * Validates the BLE packet structure and checksum. If valid, extracts the
- * gyroscope X, Y, and Z values as floating-point numbers and prints them.
+ * gyroscope X, Y, and Z values and prints them.
+ *
+ * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
+ * @return true if the packet was valid and parsed, false otherwise.
+ */
+bool ParseBLEPacket(uint8_t *buffer, uint16_t length) {
+    Gyro_Sample sample;
+
+    return ParseGyroPacket(buffer, length, &sample);
+}
+
+/**
+ * @brief Parses a BLE packet and returns its gyroscope values in Q16.16.
+ *
+ * Validates the BLE packet structure and checksum. If valid, converts the
+ * gyroscope X, Y, and Z values to Q16.16 and prints them.
  *
  * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
+ * @param sample Pointer to store the gyroscope values.
+ * @return true if the packet was valid and parsed, false otherwise.
  */
-void ParseBLEPacket(uint8_t *buffer) {
+bool ParseGyroPacket(uint8_t *buffer, uint16_t length, Gyro_Sample *sample) {
     // Validate the BLE packet
-    if (!ValidateBLEPacket(buffer)) {
+    if (!ValidateBLEPacket(buffer, length)) {
         printf("Invalid BLE Packet\r\n");
-        return;
+        return false;
     }
 
     // Extract gyroscope values from the BLE packet
-    float x = ExtractFloat(buffer, 2);  // Extract X-axis value
-    float y = ExtractFloat(buffer, 6);  // Extract Y-axis value
-    float z = ExtractFloat(buffer, 10); // Extract Z-axis value
+    sample->X = ExtractQ16(buffer, 2);  // Extract X-axis value
+    sample->Y = ExtractQ16(buffer, 6);  // Extract Y-axis value
+    sample->Z = ExtractQ16(buffer, 10); // Extract Z-axis value
 
     // Debugging output: Print the parsed gyroscope values
-    printf("Parsed Floats - X: %.2f, Y: %.2f, Z: %.2f\r\n", x, y, z);
+    char x[12], y[12], z[12];
+    printf("Parsed Floats - X: %s, Y: %s, Z: %s\r\n", FormatQ16(x, sample->X), FormatQ16(y, sample->Y), FormatQ16(z, sample->Z));
 
-    // Integrate motor control logic or pass the values to other modules here
+    return true;
 }
 
 /**
  * @brief Validates the structure of a BLE packet.
  *
- * Ensures the packet has the correct prefix (`!G`) and a valid checksum (CRC).
+ * Ensures the packet has the correct length, prefix (`!G`) and a valid checksum (CRC).
  *
  * @param buffer Pointer to the BLE packet buffer.
+ * @param length Number of valid bytes in the buffer.
  * @return true if the packet structure and CRC are valid, false otherwise.
  */
-bool ValidateBLEPacket(uint8_t *buffer) {
+bool ValidateBLEPacket(uint8_t *buffer, uint16_t length) {
+    // Check the length before reading any byte of the packet
+    if (length != GYRO_PACKET_SIZE) {
+        return false;
+    }
+
     // Check that the packet starts with the correct prefix "!G"
     if (buffer[0] != 0x21 || buffer[1] != 0x47) {
         return false;
@@ -97,13 +142,65 @@ bool ValidateCRC(uint8_t *buffer) {
  *
  * @param buffer Pointer to the BLE packet buffer.
  * @param offset Offset in the buffer where the float value starts.
- * @return The extracted floating-point value.
+ * @return The extracted floating-point value, or 0 if the float would extend past the packet.
  */
 float ExtractFloat(uint8_t *buffer, uint8_t offset) {
     float value;
 
+    // Never read past the end of the packet
+    if (offset > (GYRO_PACKET_SIZE - 4)) {
+        return 0.0f;
+    }
+
     // Copy 4 bytes from the buffer starting at the offset into the float variable
     memcpy(&value, &buffer[offset], 4);
 
     return value; // Return the extracted float value
 }
+
+/**
+ * @brief Extracts a floating-point value from a BLE packet as Q16.16 fixed point.
+ *
+ * Reads four bytes starting from the specified offset in the BLE packet, interprets them
+ * as an IEEE 754 single-precision value and converts it to Q16.16 with integer operations.
+ *
+ * @param buffer Pointer to the BLE packet buffer.
+ * @param offset Offset in the buffer where the float value starts.
+ * @return The extracted value in Q16.16, rounded toward zero and saturated to +/-GYRO_Q16_MAX,
+ *         or 0 if the float is NaN or would extend past the packet.
+ */
+int32_t ExtractQ16(uint8_t *buffer, uint8_t offset) {
+    uint32_t bits;
+
+    // Never read past the end of the packet
+    if (offset > (GYRO_PACKET_SIZE - 4)) {
+        return 0;
+    }
+
+    memcpy(&bits, &buffer[offset], 4);
+
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = (bits & 0x007FFFFF) | 0x00800000;
+    uint32_t magnitude;
+
+    // The value is mantissa * 2^(exponent - 150), so its Q16.16 value is mantissa * 2^(exponent - 134)
+    if (exponent == 0xFF) {
+        // NaN carries no value, infinity saturates
+        if (bits & 0x007FFFFF) {
+            return 0;
+        }
+        magnitude = GYRO_Q16_MAX;
+    } else if (exponent > 141) {
+        // At least 2^15, which does not fit in Q16.16
+        magnitude = GYRO_Q16_MAX;
+    } else if (exponent >= 134) {
+        magnitude = mantissa << (exponent - 134);
+    } else if (exponent > (134 - 24)) {
+        magnitude = mantissa >> (134 - exponent);
+    } else {
+        // Less than 2^-16, including zero and the subnormal values
+        magnitude = 0;
+    }
+
+    return (bits & 0x80000000) ? -(int32_t)magnitude : (int32_t)magnitude;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file Heading_Fusion.c
+ * @brief Source code for the Heading_Fusion driver.
+ *
+ * This file contains the function definitions for the Heading_Fusion driver.
+ * The Heading_Fusion driver combines the Z-axis angular rate streamed by the phone over BLE
+ * with the yaw rate derived from the wheel odometry to estimate the actual heading of the platform.
+ *
+ * @author Nainika Saha
+ */
+
+#include "../inc/Heading_Fusion.h"
+
+// Rate at which Heading_Fusion_Update() is called
+static uint16_t Heading_Fusion_Rate = 1;
+
+// Number of updates after which a gyroscope sample is no longer used
+static uint16_t Heading_Fusion_Gyro_Timeout = 1;
+
+// Latest gyroscope sample and the number of updates since it was received
+static volatile int32_t Heading_Fusion_Gyro_Sample = 0;
+static volatile uint16_t Heading_Fusion_Gyro_Age = 0xFFFF;
+
+// Odometry heading at the previous update
+static uint32_t Heading_Fusion_Previous_Wheel_Heading = 0;
+
+// Number of consecutive updates that disagree with the current slip state
+static uint8_t Heading_Fusion_Slip_Counter = 0;
+
+// Gyroscope bias in units of 1/256 milliradians per second, so that small errors still move it
+static int32_t Heading_Fusion_Bias_Q8 = 0;
+
+// Latest estimate
+static Heading_Fusion_State Heading_Fusion_Estimate;
+
+/**
+ * @brief Returns the absolute value of a 32-bit integer.
+ *
+ * @param value The value.
+ *
+ * @return The absolute value.
+ */
+static int32_t Heading_Fusion_Abs(int32_t value)
+{
+    return (value < 0) ? -value : value;
+}
+
+void Heading_Fusion_Init(uint16_t update_rate_hz)
+{
+    Odometry_Pose pose;
+    Odometry_Get_Pose(&pose);
+
+    Heading_Fusion_Rate = (update_rate_hz == 0) ? 1 : update_rate_hz;
+    Heading_Fusion_Gyro_Timeout = (Heading_Fusion_Rate / 4) + 1;
+    Heading_Fusion_Gyro_Age = 0xFFFF;
+    Heading_Fusion_Previous_Wheel_Heading = pose.Theta;
+    Heading_Fusion_Slip_Counter = 0;
+    Heading_Fusion_Bias_Q8 = 0;
+
+    memset(&Heading_Fusion_Estimate, 0, sizeof(Heading_Fusion_Estimate));
+    Heading_Fusion_Estimate.Heading = pose.Theta;
+}
+
+void Heading_Fusion_Set_Gyro_Rate(int32_t z_rate)
+{
+    // A corrupted or saturated sample cannot come from the sensor, and limiting it here keeps the
+    // fixed-point products of Heading_Fusion_Update() within 32 bits
+    if (z_rate > HEADING_FUSION_MAX_GYRO_RATE)
+    {
+        z_rate = HEADING_FUSION_MAX_GYRO_RATE;
+    }
+    else if (z_rate < -HEADING_FUSION_MAX_GYRO_RATE)
+    {
+        z_rate = -HEADING_FUSION_MAX_GYRO_RATE;
+    }
+
+    Heading_Fusion_Gyro_Sample = z_rate;
+    Heading_Fusion_Gyro_Age = 0;
+}
+
+void Heading_Fusion_Update(void)
+{
+    Heading_Fusion_State estimate = Heading_Fusion_Estimate;
+    Odometry_Pose pose;
+    Odometry_Get_Pose(&pose);
+
+    // Heading increment measured by the wheels during this period
+    int32_t wheel_delta = (int32_t)(pose.Theta - Heading_Fusion_Previous_Wheel_Heading);
+    Heading_Fusion_Previous_Wheel_Heading = pose.Theta;
+
+    estimate.Wheel_Rate = (int32_t)(((int64_t)wheel_delta * Heading_Fusion_Rate) / HEADING_FUSION_BINARY_ANGLE_PER_MRAD);
+
+    // Use only the wheels if the phone has stopped streaming
+    uint16_t age = Heading_Fusion_Gyro_Age;
+    estimate.Gyro_Valid = (age < Heading_Fusion_Gyro_Timeout) ? 0x01 : 0x00;
+
+    if (age < 0xFFFF)
+    {
+        Heading_Fusion_Gyro_Age = age + 1;
+    }
+
+    int32_t delta;
+
+    if (estimate.Gyro_Valid)
+    {
+        estimate.Gyro_Rate = Heading_Fusion_Gyro_Sample - estimate.Gyro_Bias;
+
+        // At low update rates, an increment of more than half a turn wraps like the binary angle itself
+        int32_t gyro_delta = (int32_t)(uint32_t)(((int64_t)estimate.Gyro_Rate * HEADING_FUSION_BINARY_ANGLE_PER_MRAD) / Heading_Fusion_Rate);
+        int32_t disagreement = Heading_Fusion_Abs(estimate.Gyro_Rate - estimate.Wheel_Rate);
+
+        // Change the slip state only after several consecutive updates agree, which rejects single outliers
+        uint8_t slipping_now = (disagreement > HEADING_FUSION_SLIP_THRESHOLD) ? 0x01 : 0x00;
+
+        if (slipping_now != estimate.Slip)
+        {
+            Heading_Fusion_Slip_Counter++;
+
+            if (Heading_Fusion_Slip_Counter >= HEADING_FUSION_SLIP_COUNT)
+            {
+                estimate.Slip = slipping_now;
+                Heading_Fusion_Slip_Counter = 0;
+            }
+        }
+
+        else
+        {
+            Heading_Fusion_Slip_Counter = 0;
+        }
+
+        if (estimate.Slip)
+        {
+            // The wheels do not describe the motion of the platform, so follow the gyroscope only
+            delta = gyro_delta;
+            estimate.Slip_Updates++;
+        }
+
+        else
+        {
+            // Blend the increments, pulling the gyroscope increment toward the wheel increment
+            delta = gyro_delta + (int32_t)(((int64_t)wheel_delta - gyro_delta) >> HEADING_FUSION_WHEEL_WEIGHT_SHIFT);
+
+            // Learn the gyroscope bias while the wheels report that the platform is not turning
+            if (Heading_Fusion_Abs(estimate.Wheel_Rate) <= HEADING_FUSION_STILL_THRESHOLD)
+            {
+                int32_t error = ((Heading_Fusion_Gyro_Sample - estimate.Wheel_Rate) * 256) - Heading_Fusion_Bias_Q8;
+                Heading_Fusion_Bias_Q8 += error >> HEADING_FUSION_BIAS_SHIFT;
+                estimate.Gyro_Bias = (Heading_Fusion_Bias_Q8 + 128) >> 8;
+            }
+        }
+    }
+
+    else
+    {
+        estimate.Gyro_Rate = 0;
+        estimate.Slip = 0x00;
+        Heading_Fusion_Slip_Counter = 0;
+        delta = wheel_delta;
+    }
+
+    estimate.Heading += (uint32_t)delta;
+    estimate.Yaw_Rate = (int32_t)(((int64_t)delta * Heading_Fusion_Rate) / HEADING_FUSION_BINARY_ANGLE_PER_MRAD);
+
+    // Publish the estimate in one short critical section
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    Heading_Fusion_Estimate = estimate;
+
+    __set_PRIMASK(primask);
+}
+
+void Heading_Fusion_Get(Heading_Fusion_State *state)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    *state = Heading_Fusion_Estimate;
+
+    __set_PRIMASK(primask);
+}
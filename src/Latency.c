@@ -0,0 +1,180 @@
+/**
+ * @file Latency.c
+ * @brief Source code for the Latency driver.
+ *
+ * This file contains the function definitions for the Latency driver.
+ * The Latency driver measures the end-to-end delay from the first byte of a BLE packet
+ * to the update of the PWM duty cycles of the motors.
+ *
+ * @author Nainika Saha
+ */
+
+#include "../inc/Latency.h"
+
+// Set by Latency_Init() to enable the marks
+static uint8_t Latency_Enabled = 0;
+
+// DWT cycle counter value at the start of the last packet read by BLE_UART_InString()
+static uint32_t Latency_Receive_Time = 0;
+
+// Start of the valid packet that has not reached the motors yet
+static volatile uint32_t Latency_Pending_Time = 0;
+static volatile uint8_t Latency_Pending = 0;
+
+// Number of MCLK cycles per microsecond
+static uint32_t Latency_Cycles_Per_us = 48;
+
+static Latency_Histogram Latency_Data;
+
+void Latency_Init(void)
+{
+    // Enable the DWT cycle counter, which is used to timestamp the packets and the duty cycle updates
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x00000001;
+
+    Latency_Cycles_Per_us = Clock_GetFreq() / 1000000;
+
+    if (Latency_Cycles_Per_us == 0)
+    {
+        Latency_Cycles_Per_us = 1;
+    }
+
+    Latency_Reset();
+    Latency_Enabled = 1;
+}
+
+void Latency_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    memset(&Latency_Data, 0, sizeof(Latency_Data));
+    Latency_Data.Min_us = 0xFFFFFFFF;
+    Latency_Pending = 0;
+
+    __set_PRIMASK(primask);
+}
+
+void Latency_Mark_Receive(void)
+{
+    Latency_Receive_Time = DWT->CYCCNT;
+}
+
+void Latency_Mark_Valid(void)
+{
+    if (!Latency_Enabled)
+    {
+        return;
+    }
+
+    // Prevent the control loop from completing the previous measurement while it is replaced
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (Latency_Pending)
+    {
+        Latency_Data.Dropped++;
+    }
+
+    Latency_Pending_Time = Latency_Receive_Time;
+    Latency_Pending = 1;
+
+    __set_PRIMASK(primask);
+}
+
+void Latency_Mark_Actuation(void)
+{
+    if (!Latency_Pending)
+    {
+        return;
+    }
+
+    uint32_t now = DWT->CYCCNT;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Check again, since the measurement may have been completed by an interrupt in the meantime
+    if (Latency_Pending)
+    {
+        uint32_t latency_us = (now - Latency_Pending_Time) / Latency_Cycles_Per_us;
+        uint32_t bucket = latency_us / LATENCY_BUCKET_US;
+
+        Latency_Pending = 0;
+
+        Latency_Data.Buckets[(bucket < LATENCY_BUCKET_COUNT) ? bucket : (LATENCY_BUCKET_COUNT - 1)]++;
+        Latency_Data.Count++;
+        Latency_Data.Sum_us += latency_us;
+
+        if (latency_us < Latency_Data.Min_us)
+        {
+            Latency_Data.Min_us = latency_us;
+        }
+
+        if (latency_us > Latency_Data.Max_us)
+        {
+            Latency_Data.Max_us = latency_us;
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+void Latency_Get_Histogram(Latency_Histogram *histogram)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    *histogram = Latency_Data;
+
+    __set_PRIMASK(primask);
+}
+
+void Latency_Print_Histogram(void)
+{
+    Latency_Histogram histogram;
+    Latency_Get_Histogram(&histogram);
+
+    EUSCI_A0_UART_OutString("Latency: ");
+    EUSCI_A0_UART_OutUDec(histogram.Count);
+    EUSCI_A0_UART_OutString(" packets, ");
+    EUSCI_A0_UART_OutUDec(histogram.Dropped);
+    EUSCI_A0_UART_OutString(" dropped");
+
+    if (histogram.Count > 0)
+    {
+        EUSCI_A0_UART_OutString(", min ");
+        EUSCI_A0_UART_OutUDec(histogram.Min_us);
+        EUSCI_A0_UART_OutString(" us, mean ");
+        EUSCI_A0_UART_OutUDec((uint32_t)(histogram.Sum_us / histogram.Count));
+        EUSCI_A0_UART_OutString(" us, max ");
+        EUSCI_A0_UART_OutUDec(histogram.Max_us);
+        EUSCI_A0_UART_OutString(" us");
+    }
+
+    EUSCI_A0_UART_OutString("\r\n");
+
+    for (uint32_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+    {
+        if (histogram.Buckets[i] == 0)
+        {
+            continue;
+        }
+
+        EUSCI_A0_UART_OutString("  ");
+        EUSCI_A0_UART_OutUDec(i * LATENCY_BUCKET_US);
+
+        if (i < (LATENCY_BUCKET_COUNT - 1))
+        {
+            EUSCI_A0_UART_OutString(" - ");
+            EUSCI_A0_UART_OutUDec((i + 1) * LATENCY_BUCKET_US);
+            EUSCI_A0_UART_OutString(" us: ");
+        }
+        else
+        {
+            EUSCI_A0_UART_OutString(" us or more: ");
+        }
+
+        EUSCI_A0_UART_OutUDec(histogram.Buckets[i]);
+        EUSCI_A0_UART_OutString("\r\n");
+    }
+}
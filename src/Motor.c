@@ -40,8 +40,17 @@ void Motor_Init()
     Timer_A0_PWM_Init(TIMER_A0_PERIOD_CONSTANT, 0, 0);
 }
 
+// Set by Motor_Emergency_Stop() and cleared by Motor_Clear_Emergency_Stop()
+static volatile uint8_t Motor_Emergency_Stopped = 0;
+
 void Motor_Forward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 {
+    // Keep the motors disabled until the emergency stop is cleared
+    if (Motor_Emergency_Stopped)
+    {
+        return;
+    }
+
     // Configure the motors to move in a forward direction
     // by clearing Bits 4 and 5 of the OUT register for P5
     P5->OUT &= ~0x30;
@@ -50,12 +59,21 @@ void Motor_Forward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
     Timer_A0_Update_Duty_Cycle_1(right_duty_cycle);
     Timer_A0_Update_Duty_Cycle_2(left_duty_cycle);
 
+    // Complete the latency measurement of the packet that requested this update
+    Latency_Mark_Actuation();
+
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
 }
 
 void Motor_Backward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 {
+    // Keep the motors disabled until the emergency stop is cleared
+    if (Motor_Emergency_Stopped)
+    {
+        return;
+    }
+
     // Configure the motors to move in a forward direction
     // by setting Bits 4 and 5 of the OUT register for P5
     P5->OUT |= 0x30;
@@ -64,12 +82,21 @@ void Motor_Backward(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
     Timer_A0_Update_Duty_Cycle_1(right_duty_cycle);
     Timer_A0_Update_Duty_Cycle_2(left_duty_cycle);
 
+    // Complete the latency measurement of the packet that requested this update
+    Latency_Mark_Actuation();
+
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
 }
 
 void Motor_Left(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 {
+    // Keep the motors disabled until the emergency stop is cleared
+    if (Motor_Emergency_Stopped)
+    {
+        return;
+    }
+
     // Configure the left motor to move in a backward direction
     // by setting Bit 4 of the OUT register for P5
     P5->OUT |= 0x10;
@@ -82,12 +109,21 @@ void Motor_Left(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
     Timer_A0_Update_Duty_Cycle_1(right_duty_cycle);
     Timer_A0_Update_Duty_Cycle_2(left_duty_cycle);
 
+    // Complete the latency measurement of the packet that requested this update
+    Latency_Mark_Actuation();
+
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
 }
 
 void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
 {
+    // Keep the motors disabled until the emergency stop is cleared
+    if (Motor_Emergency_Stopped)
+    {
+        return;
+    }
+
     // Configure the left motor to move in a forward direction
     // by clearing Bit 4 of the OUT register for P5
     P5->OUT &= ~0x10;
@@ -100,6 +136,9 @@ void Motor_Right(uint16_t left_duty_cycle, uint16_t right_duty_cycle)
     Timer_A0_Update_Duty_Cycle_1(right_duty_cycle);
     Timer_A0_Update_Duty_Cycle_2(left_duty_cycle);
 
+    // Complete the latency measurement of the packet that requested this update
+    Latency_Mark_Actuation();
+
     // Enable the motors by setting Bits 6 and 7 of the OUT register for P3
     P3->OUT |= 0xC0;
 }
@@ -114,4 +153,39 @@ void Motor_Stop()
     // Update the duty cycle for both motors to 0%
     Timer_A0_Update_Duty_Cycle_1(0);
     Timer_A0_Update_Duty_Cycle_2(0);
+
+    // Complete the latency measurement of the packet that requested this update
+    Latency_Mark_Actuation();
+}
+
+void Motor_Emergency_Stop()
+{
+    // Disable the motors first by clearing Bits 6 and 7 of the OUT register for P3
+    P3->OUT &= ~0xC0;
+
+    // Force the PWM outputs (P2.6 and P2.7) low by selecting the OUT bit output mode
+    // (clearing the OUTMOD field, Bits 7-5) and clearing the OUT bit (Bit 2) of CCTL[3] and CCTL[4]
+    TIMER_A0->CCTL[3] &= ~0x00E4;
+    TIMER_A0->CCTL[4] &= ~0x00E4;
+
+    Motor_Emergency_Stopped = 1;
+}
+
+void Motor_Clear_Emergency_Stop()
+{
+    // Start again from a duty cycle of 0% with the motors disabled
+    P5->OUT &= ~0x30;
+    Timer_A0_Update_Duty_Cycle_1(0);
+    Timer_A0_Update_Duty_Cycle_2(0);
+
+    // Restore the Toggle / Reset output mode by setting the OUTMOD field of CCTL[3] and CCTL[4] to 010b
+    TIMER_A0->CCTL[3] |= 0x0040;
+    TIMER_A0->CCTL[4] |= 0x0040;
+
+    Motor_Emergency_Stopped = 0;
+}
+
+uint8_t Motor_Is_Emergency_Stopped()
+{
+    return Motor_Emergency_Stopped ? 0x01 : 0x00;
 }
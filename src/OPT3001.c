@@ -20,7 +20,9 @@
  *  - OPT3001 Pin 5 (INT)       <-->  MSP432 LaunchPad Pin P4.2
  *  - OPT3001 Pin 6 (SDA)       <-->  MSP432 LaunchPad Pin P6.4
  *
- * @note Do not use with bumper sensors to avoid any pin conflicts.
+ * @note P4.2 and P4.5 are also used by BUMP_1 and BUMP_3 of the bumper sensors. When OPT3001_INTERRUPT_MODE
+ *       is defined, the Bumper_Switches driver leaves these pins to the OPT3001 and its PORT4_IRQHandler
+ *       passes the P4.2 edges to OPT3001_Interrupt_Handler().
  *
  * @note For more information regarding the Enhanced Universal Serial Communication Interface (eUSCI),
  * refer to the MSP432Pxx Microcontrollers Technical Reference Manual
@@ -31,6 +33,7 @@
  *
  */
 
+#include <stddef.h>
 #include "../inc/OPT3001.h"
 
 // An enumeration that defines constants for various commands that can be sent
@@ -71,31 +74,81 @@ typedef union{
 // Declare a config struct used when reading the configuration register
 OPT3001_Config Read_Sensor_Configuration;
 
-/**
- * @brief Writes a single command byte to the OPT3001 light sensor via I2C.
- *
- * @param command The command byte to send to the sensor.
- *
- * @return None
- */
-static void OPT3001_Write_Data(OPT3001_Commands command)
-{
-    EUSCI_B1_I2C_Send_Multiple_Bytes(OPT3001_ADDRESS, &command, 1);
-}
+// Bits of the Configuration register that are updated by the device: OVF, CRF, FH, and FL (Bits 8-5)
+#define OPT3001_CONFIG_STATUS_MASK 0x01E0
 
-/**
- * @brief Reads data from the OPT3001 light sensor via I2C.
- *
- * @param data Pointer to a uint16_t variable where the sensor data will be stored.
- *
- * @return None
- */
-static void OPT3001_Read_Data(uint16_t* data)
+// Bit of the Configuration register that selects the conversion time: CT (Bit 11)
+#define OPT3001_CONFIG_CONVERSION_TIME_MASK 0x0800
+
+// Field of the Configuration register that selects the mode of conversion operation: M[1:0] (Bits 10-9)
+#define OPT3001_CONFIG_MODE_MASK 0x0600
+
+// Bits that can change on their own in the Result, Configuration, Low-Limit, and High-Limit registers
+static const uint16_t OPT3001_Volatile_Masks[] =
 {
-    uint8_t buffer[2];
-    EUSCI_B1_I2C_Receive_Multiple_Bytes(OPT3001_ADDRESS, buffer, 2);
-    *data = buffer[1] + ((uint16_t)buffer[0] << 8);
-}
+    0xFFFF,
+    OPT3001_CONFIG_STATUS_MASK,
+    0x0000,
+    0x0000,
+};
+
+// Shadow copy of the OPT3001 registers
+static uint16_t OPT3001_Register_Values[sizeof(OPT3001_Volatile_Masks) / sizeof(OPT3001_Volatile_Masks[0])];
+static EUSCI_B1_I2C_Register_Cache OPT3001_Register_Cache;
+
+// Interrupt modes of the driver
+#define OPT3001_POLLING_MODE            0
+#define OPT3001_END_OF_CONVERSION_MODE  1
+#define OPT3001_WINDOW_MODE             2
+
+// Set by OPT3001_Enable_Conversion_Interrupt() or OPT3001_Enable_Window_Interrupt()
+static uint8_t OPT3001_Interrupt_Mode = OPT3001_POLLING_MODE;
+
+// Width of the window mode hysteresis on each side of the current level (in percent)
+static uint8_t OPT3001_Window_Hysteresis = 0;
+
+// Pointer to the user-defined function called when the level leaves the window
+static void (*OPT3001_Change_Task)(uint32_t centilux) = NULL;
+
+// Latest level cached by the interrupt modes in units of 0.01 lux
+static volatile uint32_t OPT3001_Latest_Centilux = 0;
+
+// Latest result cached by the conversion-ready interrupt mode and the time when it was captured
+static volatile OPT3001_Result OPT3001_Latest_Result;
+static volatile uint32_t OPT3001_Latest_Timestamp = 0;
+static volatile uint32_t OPT3001_Latest_Count = 0;
+
+// Time of the most recent conversion-ready interrupt
+static volatile uint32_t OPT3001_Interrupt_Timestamp = 0;
+
+// Register pointers and receive buffers used by the asynchronous register reads
+static uint8_t OPT3001_Config_Pointer = CONFIG;
+static uint8_t OPT3001_Result_Pointer = RESULT;
+static uint8_t OPT3001_Config_Buffer[2];
+static uint8_t OPT3001_Result_Buffer[2];
+
+// Transaction descriptors used by the asynchronous register reads
+static EUSCI_B1_I2C_Transaction OPT3001_Config_Transaction;
+static EUSCI_B1_I2C_Transaction OPT3001_Result_Transaction;
+
+// Consecutive failed register reads that have been retried since the last successful Result read
+static volatile uint8_t OPT3001_Retries = 0;
+
+// Set when a register read has failed OPT3001_MAX_RETRIES times in a row
+static volatile uint8_t OPT3001_Failed = 0;
+
+// Total number of failed register reads
+static volatile uint32_t OPT3001_Error_Count = 0;
+
+// Transmit buffers and transaction descriptors used to move the window in window mode
+static uint8_t OPT3001_Low_Limit_Buffer[3];
+static uint8_t OPT3001_High_Limit_Buffer[3];
+static EUSCI_B1_I2C_Transaction OPT3001_Low_Limit_Transaction;
+static EUSCI_B1_I2C_Transaction OPT3001_High_Limit_Transaction;
+
+// Transmit buffer and transaction descriptor used to change the Configuration register in an interrupt mode
+static uint8_t OPT3001_Config_Write_Buffer[3];
+static EUSCI_B1_I2C_Transaction OPT3001_Config_Write_Transaction;
 
 /**
  * @brief Reads a register from the OPT3001 sensor.
@@ -107,14 +160,15 @@ static void OPT3001_Read_Data(uint16_t* data)
 OPT3001_Result static OPT3001_Read_Register(OPT3001_Commands command)
 {
     OPT3001_Result result;
-    OPT3001_Write_Data(command);
-    OPT3001_Read_Data(&result.RawData);
+    result.RawData = EUSCI_B1_I2C_Cache_Read(&OPT3001_Register_Cache, command, 0xFFFF);
     return result;
 }
 
 /**
  * @brief This function writes a 16-bit value to a specific register on the OPT3001 sensor via I2C communication.
  *
+ * The write is skipped if the shadow copy shows that the register already holds the value.
+ *
  * @param register_address The register address to write the data to.
  * @param register_data The 16-bit data to be written to the register.
  *
@@ -122,15 +176,10 @@ OPT3001_Result static OPT3001_Read_Register(OPT3001_Commands command)
  */
 static void OPT3001_Write_Register(uint8_t register_address, uint16_t register_data)
 {
-    uint8_t buffer[] =
+    if (EUSCI_B1_I2C_Cache_Write(&OPT3001_Register_Cache, register_address, register_data))
     {
-        register_address,
-        (register_data >> 8) & 0xFF,
-        register_data & 0xFF,
-    };
-
-    EUSCI_B1_I2C_Send_Multiple_Bytes(OPT3001_ADDRESS, buffer, sizeof(buffer));
-    Clock_Delay1us(10);
+        Clock_Delay1us(10);
+    }
 }
 
 /**
@@ -148,6 +197,9 @@ static void OPT3001_Write_Configuration(OPT3001_Config config)
 /**
  * @brief This function reads the configuration from the OPT3001 sensor and returns it in an OPT3001_Config struct
  *
+ * Since the configuration register contains the status flags, this always accesses the bus,
+ * which also clears a latched interrupt.
+ *
  * @param None
  *
  * @return An OPT3001_Config structure containing the sensor's configuration data.
@@ -155,8 +207,7 @@ static void OPT3001_Write_Configuration(OPT3001_Config config)
 OPT3001_Config static OPT3001_Read_Configuration()
 {
     OPT3001_Config config;
-    OPT3001_Write_Data(CONFIG);
-    OPT3001_Read_Data(&config.RawData);
+    config.RawData = EUSCI_B1_I2C_Cache_Read(&OPT3001_Register_Cache, CONFIG, 0xFFFF);
     return config;
 }
 
@@ -189,6 +240,10 @@ void OPT3001_Init()
     // Provide a short delay of 1 millisecond after configuring the P4.5 and P4.2 pins
     Clock_Delay1ms(1);
 
+    // The sensor has just been powered, so none of the shadow registers are known yet
+    EUSCI_B1_I2C_Cache_Init(&OPT3001_Register_Cache, OPT3001_ADDRESS, OPT3001_Register_Values,
+                            OPT3001_Volatile_Masks, sizeof(OPT3001_Register_Values) / sizeof(OPT3001_Register_Values[0]));
+
     // Instantiate a new configuration struct that will be used to modify the
     // configuration settings of the OPT3001
     OPT3001_Config New_Config;
@@ -223,7 +278,471 @@ void OPT3001_Init()
 
 OPT3001_Result OPT3001_Read_Light()
 {
+    // In conversion-ready interrupt mode, return the cached result without accessing the bus
+    if (OPT3001_Interrupt_Mode)
+    {
+        OPT3001_Result result;
+        result.RawData = OPT3001_Latest_Result.RawData;
+        return result;
+    }
+
     // Read the Result Register (offset = 00h)
     // This register contains the most recent light to digital conversion
     return OPT3001_Read_Register(RESULT);
 }
+
+/**
+ * @brief Encodes a level in units of 0.01 lux into the exponent and result format of the limit registers.
+ *
+ * @param centilux The level in units of 0.01 lux.
+ *
+ * @param round_up Set to 1 to round up to the next representable level, or 0 to round down.
+ *
+ * @return The 16-bit value to write to the Low-Limit or High-Limit register.
+ */
+static uint16_t OPT3001_Encode_Limit(uint32_t centilux, uint8_t round_up)
+{
+    uint32_t exponent = 0;
+
+    // Use the smallest exponent that fits the level into the 12-bit result field (at most 1011b)
+    while (((centilux >> exponent) > 0x0FFF) && (exponent < 11))
+    {
+        exponent++;
+    }
+
+    uint32_t result = centilux >> exponent;
+
+    if (round_up && ((result << exponent) < centilux) && (result < 0x0FFF))
+    {
+        result++;
+    }
+
+    if (result > 0x0FFF)
+    {
+        result = 0x0FFF;
+    }
+
+    return (uint16_t)((exponent << 12) | result);
+}
+
+/**
+ * @brief Callback of the asynchronous Configuration, Low-Limit and High-Limit register writes.
+ *
+ * Updates the shadow copy only once the device has acknowledged the new value, so that a failed write
+ * is never mistaken for a cached value.
+ *
+ * @param transaction Pointer to the completed transaction.
+ *
+ * @return None
+ */
+static void OPT3001_Register_Write_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    if (transaction->Status == EUSCI_B1_I2C_SUCCESS)
+    {
+        uint16_t value = transaction->Write_Buffer[2] + ((uint16_t)transaction->Write_Buffer[1] << 8);
+        EUSCI_B1_I2C_Cache_Update(&OPT3001_Register_Cache, transaction->Write_Buffer[0], value);
+    }
+    else
+    {
+        // The register may or may not hold the new value, so read it from the device next time
+        EUSCI_B1_I2C_Cache_Invalidate(&OPT3001_Register_Cache);
+    }
+}
+
+/**
+ * @brief Queues asynchronous writes of a new hysteresis window around the given level.
+ *
+ * @param centilux The current level in units of 0.01 lux.
+ *
+ * @return None
+ */
+static void OPT3001_Submit_Window(uint32_t centilux)
+{
+    // Skip the update if the previous window is still being written
+    if ((OPT3001_Low_Limit_Transaction.Status == EUSCI_B1_I2C_PENDING) ||
+        (OPT3001_High_Limit_Transaction.Status == EUSCI_B1_I2C_PENDING))
+    {
+        return;
+    }
+
+    uint32_t delta = (centilux * OPT3001_Window_Hysteresis) / 100;
+
+    if (delta < OPT3001_MIN_HYSTERESIS_CENTILUX)
+    {
+        delta = OPT3001_MIN_HYSTERESIS_CENTILUX;
+    }
+
+    uint32_t low = (centilux > delta) ? (centilux - delta) : 0;
+    uint32_t high = centilux + delta;
+
+    uint16_t low_limit = OPT3001_Encode_Limit(low, 0);
+    uint16_t high_limit = OPT3001_Encode_Limit(high, 1);
+
+    OPT3001_Low_Limit_Buffer[0] = LOW_LIMIT;
+    OPT3001_Low_Limit_Buffer[1] = (low_limit >> 8) & 0xFF;
+    OPT3001_Low_Limit_Buffer[2] = low_limit & 0xFF;
+
+    OPT3001_High_Limit_Buffer[0] = HIGH_LIMIT;
+    OPT3001_High_Limit_Buffer[1] = (high_limit >> 8) & 0xFF;
+    OPT3001_High_Limit_Buffer[2] = high_limit & 0xFF;
+
+    // The shadow copy is updated by OPT3001_Register_Write_Complete() once each write has been acknowledged
+    EUSCI_B1_I2C_Submit(&OPT3001_Low_Limit_Transaction);
+    EUSCI_B1_I2C_Submit(&OPT3001_High_Limit_Transaction);
+}
+
+uint32_t OPT3001_Convert_Centilux(OPT3001_Result result)
+{
+    // lux = 0.01 * (2^Exponent) * Result, so the level in units of 0.01 lux is Result shifted by Exponent
+    return ((uint32_t)(result.RawData & 0x0FFF)) << (result.RawData >> 12);
+}
+
+/**
+ * @brief Queues the asynchronous reads of the Configuration and Result registers.
+ *
+ * The Configuration register is read first to clear the latched INT pin.
+ *
+ * @return None
+ */
+static void OPT3001_Submit_Reads(void)
+{
+    OPT3001_Interrupt_Timestamp = DWT->CYCCNT;
+
+    EUSCI_B1_I2C_Submit(&OPT3001_Config_Transaction);
+    EUSCI_B1_I2C_Submit(&OPT3001_Result_Transaction);
+}
+
+/**
+ * @brief Retries a failed register read, or enters the error state after OPT3001_MAX_RETRIES attempts.
+ *
+ * A failed read leaves the INT pin latched low, so no new falling edge would restart the reads.
+ *
+ * @param transaction Pointer to the failed transaction.
+ *
+ * @return None
+ */
+static void OPT3001_Read_Failed(EUSCI_B1_I2C_Transaction *transaction)
+{
+    OPT3001_Error_Count++;
+
+    if (OPT3001_Retries < OPT3001_MAX_RETRIES)
+    {
+        OPT3001_Retries++;
+        EUSCI_B1_I2C_Submit(transaction);
+    }
+    else
+    {
+        OPT3001_Failed = 1;
+    }
+}
+
+/**
+ * @brief Callback of the asynchronous Configuration register read.
+ *
+ * Reading the Configuration register clears the latched INT pin. The value is kept for debugging.
+ *
+ * @param transaction Pointer to the completed transaction.
+ *
+ * @return None
+ */
+static void OPT3001_Config_Read_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    if (transaction->Status == EUSCI_B1_I2C_SUCCESS)
+    {
+        Read_Sensor_Configuration.RawData = OPT3001_Config_Buffer[1] + ((uint16_t)OPT3001_Config_Buffer[0] << 8);
+        EUSCI_B1_I2C_Cache_Update(&OPT3001_Register_Cache, CONFIG, Read_Sensor_Configuration.RawData);
+    }
+    else
+    {
+        OPT3001_Read_Failed(transaction);
+    }
+}
+
+/**
+ * @brief Callback of the asynchronous Result register read.
+ *
+ * Caches the result together with the time of the conversion-ready interrupt. If the INT pin
+ * is asserted again once both reads are done, its falling edge was skipped, so the reads are restarted.
+ *
+ * @param transaction Pointer to the completed transaction.
+ *
+ * @return None
+ */
+static void OPT3001_Result_Read_Complete(EUSCI_B1_I2C_Transaction *transaction)
+{
+    if (transaction->Status == EUSCI_B1_I2C_SUCCESS)
+    {
+        OPT3001_Result result;
+        result.RawData = OPT3001_Result_Buffer[1] + ((uint16_t)OPT3001_Result_Buffer[0] << 8);
+
+        OPT3001_Latest_Result.RawData = result.RawData;
+        OPT3001_Latest_Centilux = OPT3001_Convert_Centilux(result);
+        OPT3001_Latest_Timestamp = OPT3001_Interrupt_Timestamp;
+        OPT3001_Latest_Count++;
+
+        // In window mode, an interrupt means the level has left the window, so move the window and report the change
+        if (OPT3001_Interrupt_Mode == OPT3001_WINDOW_MODE)
+        {
+            OPT3001_Submit_Window(OPT3001_Latest_Centilux);
+
+            if (OPT3001_Change_Task)
+            {
+                (*OPT3001_Change_Task)(OPT3001_Latest_Centilux);
+            }
+        }
+    }
+    else
+    {
+        OPT3001_Read_Failed(transaction);
+        return;
+    }
+
+    // Re-arm the reads if the INT pin is latched low and the Configuration read is not being retried
+    if (((P4->IN & 0x04) == 0) && (OPT3001_Config_Transaction.Status != EUSCI_B1_I2C_PENDING) && !OPT3001_Failed)
+    {
+        OPT3001_Submit_Reads();
+        return;
+    }
+
+    if (OPT3001_Config_Transaction.Status == EUSCI_B1_I2C_SUCCESS)
+    {
+        OPT3001_Retries = 0;
+    }
+}
+
+/**
+ * @brief Prepares the asynchronous transactions and enables the INT pin (P4.2) interrupt.
+ *
+ * @param mode The interrupt mode to enter (OPT3001_END_OF_CONVERSION_MODE or OPT3001_WINDOW_MODE).
+ *
+ * @return None
+ */
+static void OPT3001_Start_Interrupt_Mode(uint8_t mode)
+{
+    // Read the configuration register once to clear any latched interrupt
+    Read_Sensor_Configuration = OPT3001_Read_Configuration();
+
+    // Prepare the transaction that reads the Configuration register
+    OPT3001_Config_Transaction.Type = EUSCI_B1_I2C_WRITE_READ;
+    OPT3001_Config_Transaction.Slave_Address = OPT3001_ADDRESS;
+    OPT3001_Config_Transaction.Write_Buffer = &OPT3001_Config_Pointer;
+    OPT3001_Config_Transaction.Write_Length = 1;
+    OPT3001_Config_Transaction.Read_Buffer = OPT3001_Config_Buffer;
+    OPT3001_Config_Transaction.Read_Length = 2;
+    OPT3001_Config_Transaction.Timeout = 0;
+    OPT3001_Config_Transaction.Callback = &OPT3001_Config_Read_Complete;
+    OPT3001_Config_Transaction.Context = NULL;
+    OPT3001_Config_Transaction.Status = EUSCI_B1_I2C_IDLE;
+
+    // Prepare the transaction that reads the Result register
+    OPT3001_Result_Transaction = OPT3001_Config_Transaction;
+    OPT3001_Result_Transaction.Write_Buffer = &OPT3001_Result_Pointer;
+    OPT3001_Result_Transaction.Read_Buffer = OPT3001_Result_Buffer;
+    OPT3001_Result_Transaction.Callback = &OPT3001_Result_Read_Complete;
+
+    // Prepare the transactions that write the Low-Limit and High-Limit registers
+    OPT3001_Low_Limit_Transaction = OPT3001_Config_Transaction;
+    OPT3001_Low_Limit_Transaction.Type = EUSCI_B1_I2C_WRITE;
+    OPT3001_Low_Limit_Transaction.Write_Buffer = OPT3001_Low_Limit_Buffer;
+    OPT3001_Low_Limit_Transaction.Write_Length = 3;
+    OPT3001_Low_Limit_Transaction.Read_Buffer = NULL;
+    OPT3001_Low_Limit_Transaction.Read_Length = 0;
+    OPT3001_Low_Limit_Transaction.Callback = &OPT3001_Register_Write_Complete;
+
+    OPT3001_High_Limit_Transaction = OPT3001_Low_Limit_Transaction;
+    OPT3001_High_Limit_Transaction.Write_Buffer = OPT3001_High_Limit_Buffer;
+
+    // Prepare the transaction that changes the Configuration register
+    OPT3001_Config_Write_Transaction = OPT3001_Low_Limit_Transaction;
+    OPT3001_Config_Write_Transaction.Write_Buffer = OPT3001_Config_Write_Buffer;
+
+    OPT3001_Latest_Count = 0;
+    OPT3001_Retries = 0;
+    OPT3001_Failed = 0;
+    OPT3001_Error_Count = 0;
+    OPT3001_Interrupt_Mode = mode;
+
+    // Enable the DWT cycle counter used to timestamp the conversions
+    // by setting the TRCENA bit (Bit 24) of the DEMCR register
+    // and the CYCCNTENA bit (Bit 0) of the DWT CTRL register
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x00000001;
+
+    // Switch the EUSCI_B1_I2C driver to its interrupt-driven implementation
+    EUSCI_B1_I2C_Async_Init();
+
+    // Interrupt Edge Select: High-to-Low Transition
+    // Configure P4.2 to use a falling edge event trigger since the INT pin is active low
+    P4->IES |= 0x04;
+
+    // Clear any existing interrupt flag on P4.2 and enable its interrupt
+    P4->IFG &= ~0x04;
+    P4->IE |= 0x04;
+
+    // The priority level of IRQ 38 is left to Bumper_Switches_Init(), since PORT4_IRQHandler also
+    // runs the emergency stop of the bumpers
+
+    // Enable Interrupt 38 in NVIC (section 2.4.3.2)
+    // Bit 6 corresponds to IRQ 38
+    NVIC->ISER[1] = 0x00000040;
+}
+
+/**
+ * @brief Queues a change of the selected bits of the Configuration register while an interrupt mode is active.
+ *
+ * The busy-wait EUSCI_B1_I2C functions cannot be used once the interrupt-driven implementation is running,
+ * so the other fields are taken from the shadow copy without accessing the bus, and the write is queued with
+ * EUSCI_B1_I2C_Submit(). The shadow copy is updated by OPT3001_Register_Write_Complete().
+ *
+ * @param mask The bits of the Configuration register to change.
+ *
+ * @param value The new value of the selected bits.
+ *
+ * @return 0x01 if the write was queued. Otherwise, returns 0x00 if the previous change is still pending
+ *         or the Configuration register is not in the shadow copy.
+ */
+static uint8_t OPT3001_Submit_Config_Modify(uint16_t mask, uint16_t value)
+{
+    if ((OPT3001_Config_Write_Transaction.Status == EUSCI_B1_I2C_PENDING) ||
+        ((OPT3001_Register_Cache.Valid & (1 << CONFIG)) == 0))
+    {
+        return 0x00;
+    }
+
+    uint16_t config = (OPT3001_Register_Values[CONFIG] & ~mask) | (value & mask);
+
+    OPT3001_Config_Write_Buffer[0] = CONFIG;
+    OPT3001_Config_Write_Buffer[1] = (config >> 8) & 0xFF;
+    OPT3001_Config_Write_Buffer[2] = config & 0xFF;
+
+    return EUSCI_B1_I2C_Submit(&OPT3001_Config_Write_Transaction);
+}
+
+uint8_t OPT3001_Set_Conversion_Time(uint8_t long_conversion)
+{
+    uint16_t value = long_conversion ? OPT3001_CONFIG_CONVERSION_TIME_MASK : 0x0000;
+
+    if (OPT3001_Interrupt_Mode)
+    {
+        return OPT3001_Submit_Config_Modify(OPT3001_CONFIG_CONVERSION_TIME_MASK, value);
+    }
+
+    // Change the CT bit (Bit 11) with a single write, taking the other fields from the shadow copy
+    EUSCI_B1_I2C_Cache_Modify(&OPT3001_Register_Cache, CONFIG, OPT3001_CONFIG_CONVERSION_TIME_MASK, value);
+    return 0x01;
+}
+
+uint8_t OPT3001_Set_Conversion_Mode(uint8_t mode)
+{
+    if (OPT3001_Interrupt_Mode)
+    {
+        return OPT3001_Submit_Config_Modify(OPT3001_CONFIG_MODE_MASK, ((uint16_t)mode << 9));
+    }
+
+    // The device clears M[1:0] after a single-shot conversion, so assume shutdown to keep the write from being elided
+    if (mode == 1)
+    {
+        uint16_t config = EUSCI_B1_I2C_Cache_Read(&OPT3001_Register_Cache, CONFIG, ~OPT3001_CONFIG_STATUS_MASK);
+        EUSCI_B1_I2C_Cache_Update(&OPT3001_Register_Cache, CONFIG, config & ~OPT3001_CONFIG_MODE_MASK);
+    }
+
+    // Change the M[1:0] field (Bits 10-9) with a single write, taking the other fields from the shadow copy
+    EUSCI_B1_I2C_Cache_Modify(&OPT3001_Register_Cache, CONFIG, OPT3001_CONFIG_MODE_MASK, ((uint16_t)mode << 9));
+    return 0x01;
+}
+
+void OPT3001_Enable_Conversion_Interrupt(void)
+{
+    // Set the LE[3:0] field (Bits 15-12) of the Low-Limit register to 1100b
+    // This configures the INT pin to report the end of every conversion
+    OPT3001_Write_Register(LOW_LIMIT, 0xC000);
+
+    OPT3001_Start_Interrupt_Mode(OPT3001_END_OF_CONVERSION_MODE);
+}
+
+void OPT3001_Enable_Window_Interrupt(uint8_t hysteresis_percent, void(*task)(uint32_t centilux))
+{
+    OPT3001_Window_Hysteresis = hysteresis_percent;
+    OPT3001_Change_Task = task;
+
+    // Measure the current level and program the first window around it
+    OPT3001_Result result = OPT3001_Read_Register(RESULT);
+    uint32_t centilux = OPT3001_Convert_Centilux(result);
+    uint32_t delta = (centilux * hysteresis_percent) / 100;
+
+    if (delta < OPT3001_MIN_HYSTERESIS_CENTILUX)
+    {
+        delta = OPT3001_MIN_HYSTERESIS_CENTILUX;
+    }
+
+    OPT3001_Write_Register(LOW_LIMIT, OPT3001_Encode_Limit((centilux > delta) ? (centilux - delta) : 0, 0));
+    OPT3001_Write_Register(HIGH_LIMIT, OPT3001_Encode_Limit(centilux + delta, 1));
+
+    OPT3001_Latest_Result.RawData = result.RawData;
+    OPT3001_Latest_Centilux = centilux;
+
+    OPT3001_Start_Interrupt_Mode(OPT3001_WINDOW_MODE);
+}
+
+uint32_t OPT3001_Get_Latest_Centilux(void)
+{
+    return OPT3001_Latest_Centilux;
+}
+
+void OPT3001_Interrupt_Handler(void)
+{
+    // Clear the interrupt flag for P4.2
+    P4->IFG &= ~0x04;
+
+    // Skip this edge if the reads of the previous conversion are still in progress. The Result read
+    // callback restarts the reads if the INT pin is still asserted when they are done
+    if ((OPT3001_Config_Transaction.Status == EUSCI_B1_I2C_PENDING) ||
+        (OPT3001_Result_Transaction.Status == EUSCI_B1_I2C_PENDING))
+    {
+        return;
+    }
+
+    // A new edge (or a call from the application) leaves the error state with a fresh set of retries
+    OPT3001_Retries = 0;
+    OPT3001_Failed = 0;
+
+    OPT3001_Submit_Reads();
+}
+
+uint8_t OPT3001_Get_Error_State(uint32_t *error_count)
+{
+    if (error_count != NULL)
+    {
+        *error_count = OPT3001_Error_Count;
+    }
+
+    return OPT3001_Failed;
+}
+
+uint32_t OPT3001_Get_Latest(OPT3001_Result *result, uint32_t *timestamp)
+{
+    uint32_t count;
+    uint16_t raw_data;
+    uint32_t time;
+
+    // Repeat the copy if a new conversion was cached while reading
+    do
+    {
+        count = OPT3001_Latest_Count;
+        raw_data = OPT3001_Latest_Result.RawData;
+        time = OPT3001_Latest_Timestamp;
+    } while (count != OPT3001_Latest_Count);
+
+    if (result != NULL)
+    {
+        result->RawData = raw_data;
+    }
+
+    if (timestamp != NULL)
+    {
+        *timestamp = time;
+    }
+
+    return count;
+}
+
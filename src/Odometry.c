@@ -0,0 +1,199 @@
+/**
+ * @file Odometry.c
+ * @brief Source code for the Odometry driver.
+ *
+ * This file contains the function definitions for the Odometry driver.
+ * The Odometry driver integrates the wheel steps measured by the Tachometer driver into the
+ * position (x, y), heading (theta), and velocity of a differential-drive robot.
+ *
+ * @author Aaron Nanas
+ *
+ */
+
+#include "../inc/Odometry.h"
+
+// Sine of (i * 360 / 256) degrees in Q15 format, with an extra entry for interpolation
+static const int16_t Odometry_Sine_Table[257] =
+{
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285,
+    32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+    30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683,
+    27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868,
+    18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+    12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179,
+    6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+    0, -804, -1608, -2410, -3212, -4011, -4808, -5602,
+    -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+    -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+    -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+    -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+    -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179,
+    -6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+    0,
+};
+
+// Pose in units of 1/65536 micrometers, which keeps the fraction of a micrometer between updates
+static int64_t Odometry_X_Q16 = 0;
+static int64_t Odometry_Y_Q16 = 0;
+static uint32_t Odometry_Theta = 0;
+
+// Step counts of the previous update
+static int32_t Odometry_Previous_Left_Steps = 0;
+static int32_t Odometry_Previous_Right_Steps = 0;
+
+// Latest published pose and the sequence number that protects it
+// The sequence number is odd while the pose is being written
+static Odometry_Pose Odometry_Published_Pose;
+static volatile uint32_t Odometry_Sequence = 0;
+
+int16_t Odometry_Sin(uint32_t theta)
+{
+    // Use the upper 8 bits as the table index and the next 16 bits to interpolate
+    uint32_t index = theta >> 24;
+    int32_t fraction = (theta >> 8) & 0xFFFF;
+    int32_t start = Odometry_Sine_Table[index];
+    int32_t end = Odometry_Sine_Table[index + 1];
+
+    return (int16_t)(start + (((end - start) * fraction) >> 16));
+}
+
+int16_t Odometry_Cos(uint32_t theta)
+{
+    // cos(theta) = sin(theta + 90 degrees)
+    return Odometry_Sin(theta + 0x40000000);
+}
+
+/**
+ * @brief Converts the average period and direction of a wheel into a signed wheel speed.
+ *
+ * @param state Pointer to the state of the wheel.
+ *
+ * @return The speed of the wheel (micrometers per second), negative when the wheel turns backward.
+ */
+static int32_t Odometry_Wheel_Speed(Tachometer_Wheel_State *state)
+{
+    if (state->Average_Period == 0)
+    {
+        return 0;
+    }
+
+    // speed = (distance per step) / (period / ticks per second)
+    int64_t speed = ((int64_t)ODOMETRY_UM_PER_STEP_Q16 * ODOMETRY_TICKS_PER_SECOND / state->Average_Period) >> 16;
+
+    return (state->Direction == REVERSE) ? -(int32_t)speed : (int32_t)speed;
+}
+
+/**
+ * @brief Publishes the integrated pose for Odometry_Get_Pose().
+ *
+ * @param linear_velocity The forward velocity (millimeters per second).
+ *
+ * @param angular_velocity The rate of change of the heading (milliradians per second).
+ *
+ * @param time The Timer A3 time of the tachometer snapshot.
+ *
+ * @return None
+ */
+static void Odometry_Publish(int32_t linear_velocity, int32_t angular_velocity, uint32_t time)
+{
+    Odometry_Sequence++;
+    __DMB();
+
+    Odometry_Published_Pose.X = (int32_t)(Odometry_X_Q16 >> 16);
+    Odometry_Published_Pose.Y = (int32_t)(Odometry_Y_Q16 >> 16);
+    Odometry_Published_Pose.Theta = Odometry_Theta;
+    Odometry_Published_Pose.Linear_Velocity = linear_velocity;
+    Odometry_Published_Pose.Angular_Velocity = angular_velocity;
+    Odometry_Published_Pose.Time = time;
+
+    __DMB();
+    Odometry_Sequence++;
+}
+
+void Odometry_Init(void)
+{
+    Tachometer_Snapshot snapshot;
+    Tachometer_Get_Snapshot(&snapshot);
+
+    Odometry_Previous_Left_Steps = snapshot.Left.Steps;
+    Odometry_Previous_Right_Steps = snapshot.Right.Steps;
+
+    Odometry_Reset(0, 0, 0);
+}
+
+void Odometry_Reset(int32_t x, int32_t y, uint32_t theta)
+{
+    Odometry_X_Q16 = (int64_t)x * 65536;
+    Odometry_Y_Q16 = (int64_t)y * 65536;
+    Odometry_Theta = theta;
+
+    Odometry_Publish(0, 0, Timer_A3_Capture_Now());
+}
+
+void Odometry_Update(void)
+{
+    Tachometer_Snapshot snapshot;
+    Tachometer_Get_Snapshot(&snapshot);
+
+    // Number of steps taken by each wheel since the previous update
+    int32_t left_delta = snapshot.Left.Steps - Odometry_Previous_Left_Steps;
+    int32_t right_delta = snapshot.Right.Steps - Odometry_Previous_Right_Steps;
+
+    Odometry_Previous_Left_Steps = snapshot.Left.Steps;
+    Odometry_Previous_Right_Steps = snapshot.Right.Steps;
+
+    // Distance traveled by the center of the robot: (left + right) / 2
+    int64_t distance_q16 = ((int64_t)(left_delta + right_delta) * ODOMETRY_UM_PER_STEP_Q16) / 2;
+
+    // Change of heading: (right - left) / wheel base as a binary angle
+    int64_t delta_theta = (int64_t)(right_delta - left_delta) * ODOMETRY_BINARY_ANGLE_PER_STEP;
+
+    // Move along the average of the old and the new heading
+    uint32_t heading = Odometry_Theta + (uint32_t)(int32_t)(delta_theta / 2);
+
+    Odometry_X_Q16 += (distance_q16 * Odometry_Cos(heading)) >> 15;
+    Odometry_Y_Q16 += (distance_q16 * Odometry_Sin(heading)) >> 15;
+    Odometry_Theta += (uint32_t)(int32_t)delta_theta;
+
+    // Compute the velocities from the wheel speeds
+    int32_t left_speed = Odometry_Wheel_Speed(&snapshot.Left);
+    int32_t right_speed = Odometry_Wheel_Speed(&snapshot.Right);
+    int32_t linear_velocity = ((left_speed + right_speed) / 2) / 1000;
+    int32_t angular_velocity = (int32_t)(((int64_t)(right_speed - left_speed) * 1000) / ODOMETRY_WHEEL_BASE_UM);
+
+    Odometry_Publish(linear_velocity, angular_velocity, snapshot.Time);
+}
+
+void Odometry_Get_Pose(Odometry_Pose *pose)
+{
+    uint32_t sequence;
+
+    // Copy the pose again if it was being updated during the copy
+    do
+    {
+        sequence = Odometry_Sequence;
+        __DMB();
+
+        *pose = Odometry_Published_Pose;
+
+        __DMB();
+    } while ((sequence & 0x01) || (sequence != Odometry_Sequence));
+}
@@ -36,8 +36,21 @@
 
 #include "../inc/Reflectance_Sensor.h"
 
+// Weight of each sensor (in units of 0.1mm), shared by the Weight array and Position_Table
+#define REFLECTANCE_WEIGHT_0    334
+#define REFLECTANCE_WEIGHT_1    238
+#define REFLECTANCE_WEIGHT_2    142
+#define REFLECTANCE_WEIGHT_3    48
+#define REFLECTANCE_WEIGHT_4    -48
+#define REFLECTANCE_WEIGHT_5    -142
+#define REFLECTANCE_WEIGHT_6    -238
+#define REFLECTANCE_WEIGHT_7    -334
+
+// Position reported when no sensor is active, just beyond the rightmost sensor
+#define REFLECTANCE_NO_LINE_POSITION (REFLECTANCE_WEIGHT_0 + 1)
+
 /**
- * @brief Weight values used for sensor integration in Reflectance_Sensor_Position().
+ * @brief Weight values used for sensor integration in Reflectance_Sensor_Analog_Position().
  *
  * The Weight array contains pre-defined values corresponding to the influence of each sensor
  * in the 8-Channel QTRX Sensor Array module on the calculated position relative to the center of the line.
@@ -53,13 +66,44 @@
  * Weight[6]: Weight for the second-leftmost sensor (P7.6)
  * Weight[7]: Weight for the leftmost sensor (P7.7)
  */
-static int32_t Weight[8] = {334, 238, 142, 48, -48, -142, -238, -334};
+static int32_t Weight[8] =
+{
+    REFLECTANCE_WEIGHT_0, REFLECTANCE_WEIGHT_1, REFLECTANCE_WEIGHT_2, REFLECTANCE_WEIGHT_3,
+    REFLECTANCE_WEIGHT_4, REFLECTANCE_WEIGHT_5, REFLECTANCE_WEIGHT_6, REFLECTANCE_WEIGHT_7
+};
+
+// Compile-time helpers used to generate Position_Table from the same weights as the Weight array
+#define POSITION_WEIGHT(data, bit, weight)  ((((data) >> (bit)) & 0x01) ? (weight) : 0)
+#define POSITION_SUM(data)                  (POSITION_WEIGHT(data, 0, REFLECTANCE_WEIGHT_0) + POSITION_WEIGHT(data, 1, REFLECTANCE_WEIGHT_1) + \
+                                             POSITION_WEIGHT(data, 2, REFLECTANCE_WEIGHT_2) + POSITION_WEIGHT(data, 3, REFLECTANCE_WEIGHT_3) + \
+                                             POSITION_WEIGHT(data, 4, REFLECTANCE_WEIGHT_4) + POSITION_WEIGHT(data, 5, REFLECTANCE_WEIGHT_5) + \
+                                             POSITION_WEIGHT(data, 6, REFLECTANCE_WEIGHT_6) + POSITION_WEIGHT(data, 7, REFLECTANCE_WEIGHT_7))
+#define POSITION_COUNT(data)                ((((data) >> 0) & 0x01) + (((data) >> 1) & 0x01) + \
+                                             (((data) >> 2) & 0x01) + (((data) >> 3) & 0x01) + \
+                                             (((data) >> 4) & 0x01) + (((data) >> 5) & 0x01) + \
+                                             (((data) >> 6) & 0x01) + (((data) >> 7) & 0x01))
+#define POSITION_ENTRY(data)                {((data) ? (POSITION_SUM(data) / POSITION_COUNT(data)) : REFLECTANCE_NO_LINE_POSITION), ((data) ? 1 : 0)}
+#define POSITION_ENTRIES_4(data)            POSITION_ENTRY(data), POSITION_ENTRY((data) + 1), POSITION_ENTRY((data) + 2), POSITION_ENTRY((data) + 3)
+#define POSITION_ENTRIES_16(data)           POSITION_ENTRIES_4(data), POSITION_ENTRIES_4((data) + 4), POSITION_ENTRIES_4((data) + 8), POSITION_ENTRIES_4((data) + 12)
+#define POSITION_ENTRIES_64(data)           POSITION_ENTRIES_16(data), POSITION_ENTRIES_16((data) + 16), POSITION_ENTRIES_16((data) + 32), POSITION_ENTRIES_16((data) + 48)
 
 /**
- * @brief Bit masks used for sensor integration in Reflectance_Sensor_Position().
+ * @brief Line position for every possible 8-bit reflectance sensor reading.
+ *
+ * Each entry holds the average of the weights of the active sensors (the same result as the
+ * original loop in Reflectance_Sensor_Position()) and a flag that indicates whether any sensor is active.
+ * The table is generated by the preprocessor, so it is placed in flash and costs no time at start-up.
+ */
+static const Reflectance_Sensor_Line Position_Table[256] =
+{
+    POSITION_ENTRIES_64(0), POSITION_ENTRIES_64(64), POSITION_ENTRIES_64(128), POSITION_ENTRIES_64(192)
+};
+
+/**
+ * @brief Bit masks used to detect discharged sensors in Reflectance_Sensor_Read_Discharge().
  *
  * The Mask array contains bit masks corresponding to each sensor in the 8-Channel QTRX Sensor Array module.
- * These masks are used to isolate individual sensor readings when performing sensor integration.
+ * These masks are used to isolate the reading of each sensor from the P7 input register.
  *
  * Mask[0]: Bit mask for the rightmost sensor (P7.0)
  * Mask[1]: Bit mask for the second-rightmost sensor (P7.1)
@@ -72,6 +116,66 @@ static int32_t Weight[8] = {334, 238, 142, 48, -48, -142, -238, -334};
  */
 static int32_t Mask[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
 
+// Shortest discharge time (in microseconds) measured by each sensor, used as its white reference
+static uint16_t Reflectance_Sensor_White[REFLECTANCE_SENSOR_CHANNELS];
+
+// Longest discharge time (in microseconds) measured by each sensor, used as its black reference
+static uint16_t Reflectance_Sensor_Black[REFLECTANCE_SENSOR_CHANNELS];
+
+// Reciprocal of the calibrated range of each sensor, scaled by 2^16 * REFLECTANCE_SENSOR_GREY_MAX
+static uint32_t Reflectance_Sensor_Scale[REFLECTANCE_SENSOR_CHANNELS];
+
+// Pointer to the user-defined function called when a non-blocking read completes
+static void (*Reflectance_Sensor_Async_Task)(uint8_t reflectance_value);
+
+// Time (in microseconds) to wait after releasing the sensor pins in a non-blocking read
+static uint32_t Reflectance_Sensor_Async_Time;
+
+// Set while a non-blocking read is in progress
+static volatile uint8_t Reflectance_Sensor_Async_Busy = 0;
+
+// Set when a non-blocking read has completed and its result has not been collected yet
+static volatile uint8_t Reflectance_Sensor_Async_Ready = 0;
+
+// Result of the most recent non-blocking read
+static volatile uint8_t Reflectance_Sensor_Async_Value = 0;
+
+/**
+ * @brief Final phase of a non-blocking read: samples the sensors and turns off the IR LEDs.
+ *
+ * Called from the Timer32 interrupt once the discharge time has elapsed.
+ *
+ * @return None
+ */
+static void Reflectance_Sensor_Async_Sample(void)
+{
+    Reflectance_Sensor_Async_Value = Reflectance_Sensor_End();
+    Reflectance_Sensor_Async_Ready = 1;
+    Reflectance_Sensor_Async_Busy = 0;
+
+    if (Reflectance_Sensor_Async_Task)
+    {
+        (*Reflectance_Sensor_Async_Task)(Reflectance_Sensor_Async_Value);
+    }
+}
+
+/**
+ * @brief Second phase of a non-blocking read: releases the sensor pins so the capacitors can discharge.
+ *
+ * Called from the Timer32 interrupt once the charge time has elapsed.
+ *
+ * @return None
+ */
+static void Reflectance_Sensor_Async_Release(void)
+{
+    // Configure P7.0 - P7.7 as input GPIO pins
+    // by clearing Bits 0 to 7 of the DIR register for P7
+    P7->DIR = 0x00;
+
+    // Sample the sensors after the specified discharge time
+    Timer32_OneShot_Start(&Reflectance_Sensor_Async_Sample, Reflectance_Sensor_Async_Time);
+}
+
 void Reflectance_Sensor_Init()
 {
     // Configure P5.3 as an output GPIO pin by
@@ -98,9 +202,17 @@ void Reflectance_Sensor_Init()
 
     // Configure P7.0 - P7.7 as input GPIO pins by
     // clearing Bits 0 to 7 of the SEL0, SEL1, and DIR registers for P7
-    P7->SEL0 &= ~0xFF;
-    P7->SEL1 &= ~0xFF;
-    P7->DIR &= ~0xFF;
+    P7->SEL0 = 0x00;
+    P7->SEL1 = 0x00;
+    P7->DIR = 0x00;
+
+    // Enable the DWT cycle counter used to measure the discharge time of each sensor
+    // by setting the TRCENA bit (Bit 24) of the DEMCR register
+    // and the CYCCNTENA bit (Bit 0) of the DWT CTRL register
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x00000001;
+
+    Reflectance_Sensor_Calibration_Reset();
 }
 
 uint8_t Reflectance_Sensor_Read(uint32_t time)
@@ -126,7 +238,7 @@ uint8_t Reflectance_Sensor_Read(uint32_t time)
 
     // After waiting 10 us, configure P7.0 - P7.7 as input GPIO pins
     // by clearing Bits 0 to 7 of the DIR register for P7
-    P7->DIR &= ~0xFF;
+    P7->DIR = 0x00;
 
     // Call the Clock_Delay1us function and pass in the "time" input parameter
     Clock_Delay1us(time);
@@ -168,7 +280,7 @@ void Reflectance_Sensor_Start()
 
     // After waiting 10 us, configure P7.0 - P7.7 as input GPIO pins
     // by clearing Bits 0 to 7 of the DIR register for P7
-    P7->DIR &= ~0xFF;
+    P7->DIR = 0x00;
 }
 
 uint8_t Reflectance_Sensor_End()
@@ -189,32 +301,199 @@ uint8_t Reflectance_Sensor_End()
     return reflectance_value;
 }
 
+uint8_t Reflectance_Sensor_Read_Async(uint32_t time, void(*task)(uint8_t reflectance_value))
+{
+    // Only one read can be in progress at a time
+    if (Reflectance_Sensor_Async_Busy)
+    {
+        return 0x00;
+    }
+
+    Reflectance_Sensor_Async_Busy = 1;
+    Reflectance_Sensor_Async_Task = task;
+    Reflectance_Sensor_Async_Time = time;
+
+    // Turn on the even-numbered IR LEDs by setting Bit 3 of the OUT register for P5
+    P5->OUT |= 0x08;
+
+    // Turn on the odd-numbered IR LEDs by setting Bit 2 of the OUT register for P9
+    P9->OUT |= 0x04;
+
+    // Configure P7.0 - P7.7 as output GPIO pins by setting Bits 0 to 7 of the DIR register for P7
+    P7->DIR |= 0xFF;
+
+    // Set the P7.0 - P7.7 pins to high by setting Bits 0 to 7 of the OUT register for P7
+    P7->OUT |= 0xFF;
+
+    // Release the sensor pins once the capacitors have charged
+    Timer32_OneShot_Start(&Reflectance_Sensor_Async_Release, REFLECTANCE_SENSOR_CHARGE_TIME_US);
+
+    return 0x01;
+}
+
+uint8_t Reflectance_Sensor_Async_Result(uint8_t *reflectance_value)
+{
+    if (Reflectance_Sensor_Async_Ready == 0)
+    {
+        return 0x00;
+    }
+
+    Reflectance_Sensor_Async_Ready = 0;
+
+    if (reflectance_value)
+    {
+        *reflectance_value = Reflectance_Sensor_Async_Value;
+    }
+
+    return 0x01;
+}
+
 int32_t Reflectance_Sensor_Position(uint8_t data)
 {
-    int sum = 0;
-    int count = 0;
+    // If no sensors are active, the table holds REFLECTANCE_NO_LINE_POSITION
+    return Position_Table[data].Position;
+}
 
-    // Check if any reflectance sensors are active (i.e. data is non-zero)
-    if (data)
+Reflectance_Sensor_Line Reflectance_Sensor_Line_Lookup(uint8_t data)
+{
+    return Position_Table[data];
+}
+
+void Reflectance_Sensor_Read_Discharge(uint16_t discharge_time[], uint16_t timeout)
+{
+    uint32_t cycles_per_us = Clock_GetFreq() / 1000000;
+    uint32_t timeout_cycles = timeout * cycles_per_us;
+
+    // Each bit that is set corresponds to a sensor that has not discharged yet
+    uint8_t pending = 0xFF;
+
+    // Report every sensor as the timeout value unless it discharges earlier
+    for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
     {
-        // Iterate through each reflectance sensor
-        for(int i = 0; i < 8; i++)
+        discharge_time[i] = timeout;
+    }
+
+    // Turn on the IR LEDs, charge the capacitors, and release the sensor pins
+    Reflectance_Sensor_Start();
+
+    uint32_t start_time = DWT->CYCCNT;
+
+    while (pending)
+    {
+        uint32_t elapsed_cycles = DWT->CYCCNT - start_time;
+
+        if (elapsed_cycles >= timeout_cycles)
+        {
+            break;
+        }
+
+        // Find the sensors that have discharged since the last sample
+        uint8_t discharged = pending & ~(P7->IN);
+
+        if (discharged)
         {
-            // Check if the sensor is active based on the bit position in the data
-            if (data & Mask[i])
+            uint16_t elapsed_us = elapsed_cycles / cycles_per_us;
+
+            for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
             {
-                // Sum the weighted position value of the active sensor
-                sum = sum + Weight[i];
-                count++;
+                if (discharged & Mask[i])
+                {
+                    discharge_time[i] = elapsed_us;
+                }
             }
+
+            pending &= ~discharged;
         }
+    }
+
+    // Turn off the even-numbered IR LEDs by clearing Bit 3 of the OUT register for P5
+    P5->OUT &= ~0x08;
+
+    // Turn off the odd-numbered IR LEDs by clearing Bit 2 of the OUT register for P9
+    P9->OUT &= ~0x04;
+}
 
-        // Calculate the average position based on the active sensors
-        return sum/count;
+void Reflectance_Sensor_Calibration_Reset()
+{
+    for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
+    {
+        Reflectance_Sensor_White[i] = 0xFFFF;
+        Reflectance_Sensor_Black[i] = 0;
+        Reflectance_Sensor_Scale[i] = 0;
     }
-    else
+}
+
+void Reflectance_Sensor_Calibration_Update(const uint16_t discharge_time[])
+{
+    for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
     {
-        // If no sensors are active, return a default position value
-        return Weight[0] + 1;
+        uint8_t changed = 0;
+
+        if (discharge_time[i] < Reflectance_Sensor_White[i])
+        {
+            Reflectance_Sensor_White[i] = discharge_time[i];
+            changed = 1;
+        }
+
+        if (discharge_time[i] > Reflectance_Sensor_Black[i])
+        {
+            Reflectance_Sensor_Black[i] = discharge_time[i];
+            changed = 1;
+        }
+
+        // Recompute the reciprocal only when the calibrated range has changed
+        if (changed && (Reflectance_Sensor_Black[i] > Reflectance_Sensor_White[i]))
+        {
+            uint32_t range = Reflectance_Sensor_Black[i] - Reflectance_Sensor_White[i];
+            Reflectance_Sensor_Scale[i] = ((uint32_t)REFLECTANCE_SENSOR_GREY_MAX << 16) / range;
+        }
+    }
+}
+
+void Reflectance_Sensor_Normalize(const uint16_t discharge_time[], uint16_t grey[])
+{
+    for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
+    {
+        uint32_t value = 0;
+
+        if (discharge_time[i] > Reflectance_Sensor_White[i])
+        {
+            uint64_t offset = discharge_time[i] - Reflectance_Sensor_White[i];
+            value = (uint32_t)((offset * Reflectance_Sensor_Scale[i]) >> 16);
+        }
+
+        // Limit the result to the full-scale value for readings darker than the black reference
+        if (value > REFLECTANCE_SENSOR_GREY_MAX)
+        {
+            value = REFLECTANCE_SENSOR_GREY_MAX;
+        }
+
+        grey[i] = value;
+    }
+}
+
+uint8_t Reflectance_Sensor_Analog_Position(const uint16_t grey[], int32_t *position)
+{
+    int32_t sum = 0;
+    int32_t total = 0;
+
+    for (int i = 0; i < REFLECTANCE_SENSOR_CHANNELS; i++)
+    {
+        // Ignore sensors that are close to the white reference to reject noise from the background
+        if (grey[i] >= REFLECTANCE_SENSOR_GREY_NOISE)
+        {
+            sum = sum + (Weight[i] * grey[i]);
+            total = total + grey[i];
+        }
     }
+
+    if (total == 0)
+    {
+        // If no sensors see the line, return the same default position as Reflectance_Sensor_Position()
+        *position = REFLECTANCE_NO_LINE_POSITION;
+        return 0x00;
+    }
+
+    *position = sum / total;
+    return 0x01;
 }
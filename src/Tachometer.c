@@ -19,16 +19,16 @@
 #include "../inc/Tachometer.h"
 
 // Global variable used to store the time of the previous rising edge for the right wheel
-static uint16_t Tachometer_Previous_Right_Time;
+static uint32_t Tachometer_Previous_Right_Time;
 
 // Global variable used to store the time of the current rising edge for the right wheel
-static uint16_t Tachometer_Current_Right_Time;
+static uint32_t Tachometer_Current_Right_Time;
 
 // Global variable used to store the time of the previous rising edge for the left wheel
-static uint16_t Tachometer_Previous_Left_Time;
+static uint32_t Tachometer_Previous_Left_Time;
 
 // Global variable used to store the time of the current rising edge for the left wheel
-static uint16_t Tachometer_Current_Left_Time;
+static uint32_t Tachometer_Current_Left_Time;
 
 // Global variable used to keep track of the number of steps.
 // Increments with every step forward. Decrements with every step backward
@@ -41,13 +41,156 @@ static int Tachometer_Left_Steps = 0;
 enum Tachometer_Direction Tachometer_Right_Dir = STOPPED;
 enum Tachometer_Direction Tachometer_Left_Dir = STOPPED;
 
+// Period history of one wheel that is maintained by the capture interrupts
+typedef struct
+{
+    // Ring buffer of the periods that are averaged and the running sum of its contents
+    uint32_t Periods[TACHOMETER_PERIOD_BUFFER_SIZE];
+    uint8_t Period_Index;
+    uint8_t Period_Count;
+    uint32_t Period_Sum;
+
+    // Last raw periods used by the median filter
+    uint32_t Raw[TACHOMETER_MEDIAN_SIZE];
+    uint8_t Raw_Index;
+    uint8_t Raw_Count;
+
+    // Set once the first edge has been captured, since the first period is not valid
+    uint8_t Started;
+
+    // Set when a reader has detected a stall and cleared by the next edge, so that a stopped
+    // wheel is not reported as moving again once the 32-bit time wraps
+    volatile uint8_t Stalled;
+} Tachometer_History;
+
+static Tachometer_History Tachometer_Right_History;
+static Tachometer_History Tachometer_Left_History;
+
+// Set by Tachometer_Set_Median_Filter()
+static uint8_t Tachometer_Median_Filter = 0;
+
+// Incremented by the capture interrupts before and after they update the state of a wheel
+// The value is odd while an update is in progress
+static volatile uint32_t Tachometer_Sequence = 0;
+
+// Copy of the state of one wheel taken by Tachometer_Read_Raw()
+typedef struct
+{
+    uint32_t Previous_Time;
+    uint32_t Current_Time;
+    uint32_t Period_Sum;
+    uint8_t Period_Count;
+    uint8_t Started;
+    uint8_t Stalled;
+    int32_t Steps;
+    enum Tachometer_Direction Direction;
+} Tachometer_Raw;
+
+// Time without an edge after which a wheel is reported as stopped (units of 83.3 ns)
+static uint32_t Tachometer_Stall_Ticks = TACHOMETER_DEFAULT_STALL_TIMEOUT_MS * TACHOMETER_TICKS_PER_MS;
+
+/**
+ * @brief Returns the median of five values using a fixed sequence of compare-and-swap steps.
+ *
+ * @param values Pointer to the five values. The array is not modified.
+ *
+ * @return The median value.
+ */
+static uint32_t Tachometer_Median_Of_5(const uint32_t *values)
+{
+    uint32_t v[TACHOMETER_MEDIAN_SIZE];
+    uint32_t t;
+
+    for (int i = 0; i < TACHOMETER_MEDIAN_SIZE; i++)
+    {
+        v[i] = values[i];
+    }
+
+    // Seven compare-and-swap steps leave the median in v[2]
+    if (v[0] > v[1]) { t = v[0]; v[0] = v[1]; v[1] = t; }
+    if (v[3] > v[4]) { t = v[3]; v[3] = v[4]; v[4] = t; }
+    if (v[0] > v[3]) { t = v[0]; v[0] = v[3]; v[3] = t; }
+    if (v[1] > v[4]) { t = v[1]; v[1] = v[4]; v[4] = t; }
+    if (v[1] > v[2]) { t = v[1]; v[1] = v[2]; v[2] = t; }
+    if (v[2] > v[3]) { t = v[2]; v[2] = v[3]; v[3] = t; }
+    if (v[1] > v[2]) { t = v[1]; v[1] = v[2]; v[2] = t; }
+
+    return v[2];
+}
+
+/**
+ * @brief Adds a measured period to the history of a wheel.
+ *
+ * @param history Pointer to the history of the wheel.
+ *
+ * @param period The measured period (units of 83.3 ns).
+ *
+ * @return None
+ */
+static void Tachometer_Push_Period(Tachometer_History *history, uint32_t period)
+{
+    // A period longer than the stall timeout means that the wheel was stopped, so start a new history
+    if (period > Tachometer_Stall_Ticks)
+    {
+        history->Period_Count = 0;
+        history->Period_Index = 0;
+        history->Period_Sum = 0;
+        history->Raw_Count = 0;
+        history->Raw_Index = 0;
+        return;
+    }
+
+    // Keep the last raw periods for the median filter
+    history->Raw[history->Raw_Index] = period;
+    history->Raw_Index = (history->Raw_Index + 1 == TACHOMETER_MEDIAN_SIZE) ? 0 : (history->Raw_Index + 1);
+
+    if (history->Raw_Count < TACHOMETER_MEDIAN_SIZE)
+    {
+        history->Raw_Count++;
+    }
+
+    else if (Tachometer_Median_Filter)
+    {
+        period = Tachometer_Median_Of_5(history->Raw);
+    }
+
+    // Replace the oldest period in the ring buffer and update the sum incrementally
+    if (history->Period_Count < TACHOMETER_PERIOD_BUFFER_SIZE)
+    {
+        history->Period_Count++;
+    }
+
+    else
+    {
+        history->Period_Sum -= history->Periods[history->Period_Index];
+    }
+
+    history->Periods[history->Period_Index] = period;
+    history->Period_Sum += period;
+    history->Period_Index = (history->Period_Index + 1) & (TACHOMETER_PERIOD_BUFFER_SIZE - 1);
+}
+
 void Tachometer_Right_Int(uint16_t current_time)
 {
+    // Mark the state as being updated for Tachometer_Read_Raw()
+    Tachometer_Sequence++;
+    __DMB();
+
     // Store the time of the previous rising edge for the right wheel
     Tachometer_Previous_Right_Time = Tachometer_Current_Right_Time;
 
     // Store the time of the current rising edge for the right wheel
-    Tachometer_Current_Right_Time = current_time;
+    // The time is extended to 32 bits so that periods longer than one Timer A3 wrap are measured correctly
+    Tachometer_Current_Right_Time = Timer_A3_Capture_Extend(current_time);
+
+    // Add the period to the history once two edges have been captured
+    if (Tachometer_Right_History.Started)
+    {
+        Tachometer_Push_Period(&Tachometer_Right_History, Tachometer_Current_Right_Time - Tachometer_Previous_Right_Time);
+    }
+
+    Tachometer_Right_History.Started = 1;
+    Tachometer_Right_History.Stalled = 0;
 
     // Check if P5.0 (Right Encoder B) is low
     if ((P5->IN & 0x01) == 0)
@@ -63,15 +206,33 @@ void Tachometer_Right_Int(uint16_t current_time)
         Tachometer_Right_Steps = Tachometer_Right_Steps + 1;
         Tachometer_Right_Dir = FORWARD;
     }
+
+    // Mark the update as complete
+    __DMB();
+    Tachometer_Sequence++;
 }
 
 void Tachometer_Left_Int(uint16_t current_time)
 {
+    // Mark the state as being updated for Tachometer_Read_Raw()
+    Tachometer_Sequence++;
+    __DMB();
+
     // Store the time of the previous rising edge for the left wheel
     Tachometer_Previous_Left_Time = Tachometer_Current_Left_Time;
 
     // Store the time of the current rising edge for the left wheel
-    Tachometer_Current_Left_Time = current_time;
+    // The time is extended to 32 bits so that periods longer than one Timer A3 wrap are measured correctly
+    Tachometer_Current_Left_Time = Timer_A3_Capture_Extend(current_time);
+
+    // Add the period to the history once two edges have been captured
+    if (Tachometer_Left_History.Started)
+    {
+        Tachometer_Push_Period(&Tachometer_Left_History, Tachometer_Current_Left_Time - Tachometer_Previous_Left_Time);
+    }
+
+    Tachometer_Left_History.Started = 1;
+    Tachometer_Left_History.Stalled = 0;
 
     // Check if P5.2 (Left Encoder B) is low
     if ((P5->IN & 0x04) == 0)
@@ -87,6 +248,10 @@ void Tachometer_Left_Int(uint16_t current_time)
         Tachometer_Left_Steps = Tachometer_Left_Steps + 1;
         Tachometer_Left_Dir = FORWARD;
     }
+
+    // Mark the update as complete
+    __DMB();
+    Tachometer_Sequence++;
 }
 
 void Tachometer_Init()
@@ -102,6 +267,136 @@ void Tachometer_Init()
     Timer_A3_Capture_Init(&Tachometer_Right_Int, &Tachometer_Left_Int);
 }
 
+/**
+ * @brief Takes a consistent copy of the state of both wheels.
+ *
+ * The capture interrupts make Tachometer_Sequence odd while they update the state and even again
+ * when they are done. The copy is repeated until it was taken while the sequence was even and unchanged,
+ * so interrupts are never disabled and the capture interrupts are never delayed.
+ *
+ * @param left Pointer to store the state of the left wheel.
+ *
+ * @param right Pointer to store the state of the right wheel.
+ *
+ * @return The sequence number of the copy.
+ */
+static uint32_t Tachometer_Read_Raw(Tachometer_Raw *left, Tachometer_Raw *right)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = Tachometer_Sequence;
+        __DMB();
+
+        left->Previous_Time = Tachometer_Previous_Left_Time;
+        left->Current_Time = Tachometer_Current_Left_Time;
+        left->Period_Sum = Tachometer_Left_History.Period_Sum;
+        left->Period_Count = Tachometer_Left_History.Period_Count;
+        left->Started = Tachometer_Left_History.Started;
+        left->Stalled = Tachometer_Left_History.Stalled;
+        left->Steps = Tachometer_Left_Steps;
+        left->Direction = Tachometer_Left_Dir;
+
+        right->Previous_Time = Tachometer_Previous_Right_Time;
+        right->Current_Time = Tachometer_Current_Right_Time;
+        right->Period_Sum = Tachometer_Right_History.Period_Sum;
+        right->Period_Count = Tachometer_Right_History.Period_Count;
+        right->Started = Tachometer_Right_History.Started;
+        right->Stalled = Tachometer_Right_History.Stalled;
+        right->Steps = Tachometer_Right_Steps;
+        right->Direction = Tachometer_Right_Dir;
+
+        __DMB();
+    } while ((sequence & 0x01) || (sequence != Tachometer_Sequence));
+
+    return sequence;
+}
+
+/**
+ * @brief Converts a copy of the state of one wheel into the format of Tachometer_Wheel_State.
+ *
+ * A wheel is stopped if it has not produced a valid period yet, or if it has not produced an edge
+ * within the stall timeout. A newly detected stall is recorded in the history of the wheel, unless
+ * an edge has been captured since the copy was taken.
+ *
+ * @param state Pointer to store the converted state.
+ *
+ * @param raw Pointer to the copy of the state.
+ *
+ * @param history Pointer to the history of the wheel.
+ *
+ * @param now The 32-bit time at which the copy was taken.
+ *
+ * @param sequence The value of the sequence counter returned by Tachometer_Read_Raw() with the copy.
+ *
+ * @return None
+ */
+static void Tachometer_Fill_State(Tachometer_Wheel_State *state, Tachometer_Raw *raw, Tachometer_History *history,
+                                  uint32_t now, uint32_t sequence)
+{
+    uint8_t stalled = (raw->Started == 0) || (raw->Period_Count == 0) || raw->Stalled;
+
+    if (!stalled && ((now - raw->Current_Time) > Tachometer_Stall_Ticks))
+    {
+        // The capture interrupts clear the flag on every edge, so only set it if no edge has been
+        // captured since the copy. Otherwise, the stall is detected again on the next read
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+
+        if (Tachometer_Sequence == sequence)
+        {
+            history->Stalled = 1;
+        }
+
+        __set_PRIMASK(primask);
+        stalled = 1;
+    }
+
+    state->Edge_Time = raw->Current_Time;
+    state->Steps = raw->Steps;
+
+    if (stalled)
+    {
+        state->Period = 0;
+        state->Average_Period = 0;
+        state->Direction = STOPPED;
+    }
+
+    else
+    {
+        state->Period = raw->Current_Time - raw->Previous_Time;
+        state->Average_Period = raw->Period_Sum / raw->Period_Count;
+        state->Direction = raw->Direction;
+    }
+}
+
+/**
+ * @brief Saturates a 32-bit period to the 16-bit format of Tachometer_Get().
+ *
+ * @param period The 32-bit period.
+ *
+ * @return The period, or 0xFFFF if it does not fit in 16 bits.
+ */
+static uint16_t Tachometer_Saturate(uint32_t period)
+{
+    return (period > 0xFFFF) ? 0xFFFF : (uint16_t)period;
+}
+
+void Tachometer_Get_Snapshot(Tachometer_Snapshot *snapshot)
+{
+    Tachometer_Raw left;
+    Tachometer_Raw right;
+
+    snapshot->Sequence = Tachometer_Read_Raw(&left, &right);
+
+    // Read the time after the copy so that it is never earlier than the copied edge times
+    snapshot->Time = Timer_A3_Capture_Now();
+
+    Tachometer_Fill_State(&snapshot->Left, &left, &Tachometer_Left_History, snapshot->Time, snapshot->Sequence);
+    Tachometer_Fill_State(&snapshot->Right, &right, &Tachometer_Right_History, snapshot->Time, snapshot->Sequence);
+}
+
 void Tachometer_Get(uint16_t *left_tach,
                     enum Tachometer_Direction *left_dir,
                     int32_t *left_steps,
@@ -109,12 +404,67 @@ void Tachometer_Get(uint16_t *left_tach,
                     enum Tachometer_Direction *right_dir,
                     int32_t *right_steps)
 {
-    *left_tach = (Tachometer_Current_Left_Time - Tachometer_Previous_Left_Time);
-    *left_dir = Tachometer_Left_Dir;
-    *left_steps = Tachometer_Left_Steps;
-    *right_tach = (Tachometer_Current_Right_Time - Tachometer_Previous_Right_Time);
-    *right_dir = Tachometer_Right_Dir;
-    *right_steps = Tachometer_Right_Steps;
+    Tachometer_Snapshot snapshot;
+    Tachometer_Get_Snapshot(&snapshot);
+
+    *left_tach = Tachometer_Saturate(snapshot.Left.Period);
+    *left_dir = snapshot.Left.Direction;
+    *left_steps = snapshot.Left.Steps;
+    *right_tach = Tachometer_Saturate(snapshot.Right.Period);
+    *right_dir = snapshot.Right.Direction;
+    *right_steps = snapshot.Right.Steps;
+}
+
+void Tachometer_Get_Average(uint32_t *left_tach, uint32_t *right_tach)
+{
+    Tachometer_Snapshot snapshot;
+    Tachometer_Get_Snapshot(&snapshot);
+
+    *left_tach = snapshot.Left.Average_Period;
+    *right_tach = snapshot.Right.Average_Period;
+}
+
+/**
+ * @brief Converts an average period and direction into a signed speed.
+ *
+ * @param state Pointer to the state of the wheel.
+ *
+ * @return The speed of the wheel (RPM), negative when the wheel turns backward.
+ */
+static int16_t Tachometer_State_RPM(Tachometer_Wheel_State *state)
+{
+    if (state->Average_Period == 0)
+    {
+        return 0;
+    }
+
+    int16_t rpm = (int16_t)(TACHOMETER_RPM_CONSTANT / state->Average_Period);
+
+    return (state->Direction == REVERSE) ? -rpm : rpm;
+}
+
+void Tachometer_Get_RPM(int16_t *left_rpm, int16_t *right_rpm)
+{
+    Tachometer_Snapshot snapshot;
+    Tachometer_Get_Snapshot(&snapshot);
+
+    *left_rpm = Tachometer_State_RPM(&snapshot.Left);
+    *right_rpm = Tachometer_State_RPM(&snapshot.Right);
+}
+
+void Tachometer_Set_Stall_Timeout(uint32_t timeout_ms)
+{
+    if (timeout_ms > TACHOMETER_MAX_STALL_TIMEOUT_MS)
+    {
+        timeout_ms = TACHOMETER_MAX_STALL_TIMEOUT_MS;
+    }
+
+    Tachometer_Stall_Ticks = timeout_ms * TACHOMETER_TICKS_PER_MS;
+}
+
+void Tachometer_Set_Median_Filter(uint8_t enable)
+{
+    Tachometer_Median_Filter = enable;
 }
 
 uint16_t Average_of_Buffer(uint16_t *buffer, int buffer_length)
@@ -0,0 +1,131 @@
+/**
+ * @file Timer32_OneShot.c
+ * @brief Source code for the Timer32_OneShot driver.
+ *
+ * This file contains the function definitions for the Timer32_OneShot driver.
+ * It uses a Timer32 module (TIMER32_1 or TIMER32_2) in one-shot mode to call a user-defined
+ * function once after a specified delay, without blocking the CPU while waiting.
+ *
+ * @note Timer32 is clocked by MCLK. The delay is converted to clock cycles using Clock_GetFreq().
+ *
+ * @author Aaron Nanas
+ *
+ */
+
+#include "../inc/Timer32_OneShot.h"
+
+// Registers of each Timer32 module
+static Timer32_Type * const Timer32_OneShot_Modules[2] = {TIMER32_1, TIMER32_2};
+
+// Pointers to the user-defined functions of each Timer32 module
+static void (*Timer32_OneShot_Tasks[2])(void);
+
+void Timer32_OneShot_Timer_Init(Timer32_OneShot_Timer timer, uint8_t priority)
+{
+    Timer32_Type *module = Timer32_OneShot_Modules[timer];
+
+    // TIMER32_1 and TIMER32_2 have the IRQ numbers 25 and 26
+    uint32_t irq = 25 + timer;
+
+    // Halt the timer by clearing the ENABLE bit (Bit 7) in the CONTROL register
+    module->CONTROL &= ~0x0080;
+
+    // Modify the following bits in the CONTROL register
+    // Free-running mode, ignored in one-shot mode (Bit 6 = 0)
+    // Interrupt Enable (Bit 5 = 1)
+    // Prescale value of 1 (Bits 3-2 = 00b)
+    // 32-bit counter (Bit 1 = 1)
+    // One-shot mode (Bit 0 = 1)
+    module->CONTROL = 0x0023;
+
+    // Clear any pending interrupt by writing to the INTCLR register
+    module->INTCLR = 0;
+
+    // Set the interrupt priority level using the IPR6 register of NVIC,
+    // which holds the priorities of IRQ 24 to 27 in its four bytes (upper 3 bits of each)
+    uint32_t shift = ((irq - 24) * 8) + 5;
+    NVIC->IP[6] = (NVIC->IP[6] & ~((uint32_t)0x07 << shift)) | ((uint32_t)(priority & 0x07) << shift);
+
+    // Enable the interrupt in NVIC by setting the corresponding bit of the ISER register
+    NVIC->ISER[0] |= ((uint32_t)1 << irq);
+}
+
+void Timer32_OneShot_Timer_Start(Timer32_OneShot_Timer timer, void(*task)(void), uint32_t delay_us)
+{
+    Timer32_Type *module = Timer32_OneShot_Modules[timer];
+
+    // Halt the timer so that a pending delay is cancelled
+    module->CONTROL &= ~0x0080;
+
+    // Store the user-defined task function for use during interrupt handling
+    Timer32_OneShot_Tasks[timer] = task;
+
+    // Convert the delay to MCLK cycles and load it into the counter
+    module->LOAD = delay_us * (Clock_GetFreq() / 1000000);
+
+    // Clear any pending interrupt by writing to the INTCLR register
+    module->INTCLR = 0;
+
+    // Start counting down by setting the ENABLE bit (Bit 7) in the CONTROL register
+    module->CONTROL |= 0x0080;
+}
+
+void Timer32_OneShot_Timer_Stop(Timer32_OneShot_Timer timer)
+{
+    Timer32_Type *module = Timer32_OneShot_Modules[timer];
+
+    // Halt the timer by clearing the ENABLE bit (Bit 7) in the CONTROL register
+    module->CONTROL &= ~0x0080;
+
+    // Clear any pending interrupt by writing to the INTCLR register
+    module->INTCLR = 0;
+}
+
+void Timer32_OneShot_Init(void)
+{
+    Timer32_OneShot_Timer_Init(TIMER32_ONESHOT_1, 2);
+}
+
+void Timer32_OneShot_Start(void(*task)(void), uint32_t delay_us)
+{
+    Timer32_OneShot_Timer_Start(TIMER32_ONESHOT_1, task, delay_us);
+}
+
+void Timer32_OneShot_Stop(void)
+{
+    Timer32_OneShot_Timer_Stop(TIMER32_ONESHOT_1);
+}
+
+/**
+ * @brief Handles the expiry of a one-shot delay.
+ *
+ * @param timer The Timer32 module whose delay has expired.
+ *
+ * @return None
+ */
+static void Timer32_OneShot_Expired(Timer32_OneShot_Timer timer)
+{
+    Timer32_Type *module = Timer32_OneShot_Modules[timer];
+
+    // Acknowledge the interrupt and clear it by writing to the INTCLR register
+    module->INTCLR = 0;
+
+    // Halt the timer until the next delay is started
+    module->CONTROL &= ~0x0080;
+
+    // Execute the user-defined task
+    if (Timer32_OneShot_Tasks[timer])
+    {
+        (*Timer32_OneShot_Tasks[timer])();
+    }
+}
+
+void T32_INT1_IRQHandler(void)
+{
+    Timer32_OneShot_Expired(TIMER32_ONESHOT_1);
+}
+
+void T32_INT2_IRQHandler(void)
+{
+    Timer32_OneShot_Expired(TIMER32_ONESHOT_2);
+}
@@ -16,6 +16,9 @@
 
 #include "../inc/Timer_A3_Capture.h"
 
+// Number of times Timer A3 has wrapped from 0xFFFF to 0x0000
+static volatile uint16_t Timer_A3_Overflow_Count = 0;
+
 void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t time))
 {
     // Store the first user-defined task function for use during interrupt handling
@@ -74,11 +77,57 @@ void Timer_A3_Capture_Init(void(*task0)(uint16_t time), void(*task1)(uint16_t ti
     // Enable Interrupt 14 and 15 in NVIC by setting Bits 14 and 15 of the ISER[0] register
     NVIC->ISER[0] |= 0x0000C000;
 
+    // Enable the overflow interrupt by setting the TAIE bit (Bit 1) in the CTL register
+    // The TAIFG flag (Bit 0) is reported through TA3_N_IRQHandler
+    Timer_A3_Overflow_Count = 0;
+    TIMER_A3->CTL &= ~0x0001;
+    TIMER_A3->CTL |= 0x0002;
+
     // Set the TACLR bit and enable Timer A3 in continuous mode using the
     // MC bits in the CTL register
     TIMER_A3->CTL |= 0x0024;
 }
 
+/**
+ * @brief Combines a 16-bit timer value with the overflow count.
+ *
+ * If the TAIFG flag (Bit 0) of the CTL register is set, the timer has wrapped but the overflow
+ * has not been counted yet. A value in the lower half of the range was then taken after the wrap.
+ *
+ * @param time A 16-bit timer value that was read after the overflow count could have last changed.
+ *
+ * @return The 32-bit time.
+ */
+static uint32_t Timer_A3_Combine(uint16_t time)
+{
+    uint32_t overflows = Timer_A3_Overflow_Count;
+
+    if ((TIMER_A3->CTL & 0x0001) && (time < 0x8000))
+    {
+        overflows++;
+    }
+
+    return (overflows << 16) | time;
+}
+
+uint32_t Timer_A3_Capture_Extend(uint16_t time)
+{
+    return Timer_A3_Combine(time);
+}
+
+uint32_t Timer_A3_Capture_Now(void)
+{
+    // Prevent the overflow interrupt from running between reading the timer and the overflow count
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = Timer_A3_Combine(TIMER_A3->R);
+
+    __set_PRIMASK(primask);
+
+    return now;
+}
+
 void TA3_0_IRQHandler(void)
 {
     // Acknowledge the Capture/Compare interrupt and clear Bit 0 of the CCTL[0] register
@@ -90,9 +139,27 @@ void TA3_0_IRQHandler(void)
 
 void TA3_N_IRQHandler(void)
 {
-    // Acknowledge the Capture/Compare interrupt and clear Bit 0 of the CCTL[1] register
-    TIMER_A3->CCTL[1] &= ~0x0001;
-
-    // Execute the user-defined task and pass the timer value from CCR[1]
-    (*Timer_A3_Capture_Task_1)(TIMER_A3->CCR[1]);
+    // Reading the TAxIV register returns the highest-priority pending source and clears its flag
+    switch (TIMER_A3->IV)
+    {
+        // Capture/Compare 1 (CCR[1])
+        case 0x02:
+        {
+            // Execute the user-defined task and pass the timer value from CCR[1]
+            (*Timer_A3_Capture_Task_1)(TIMER_A3->CCR[1]);
+            break;
+        }
+
+        // Timer overflow (TAIFG)
+        case 0x0E:
+        {
+            Timer_A3_Overflow_Count++;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
 }
@@ -0,0 +1,54 @@
+/**
+ * @file Test_Analog_Distance_Sensors.c
+ * @brief Host test of the distance lookup at the ends of the 14-bit ADC range.
+ *
+ * Readings above 16383 cannot come from the ADC14, but they must be limited to the last table
+ * entry instead of wrapping to the start of the table, which would report a far distance for an
+ * obstacle at the closest measurable range.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "inc/Analog_Distance_Sensors.h"
+
+static int Test_Failures;
+
+static void Test_Expect_Equal(const char *name, uint32_t reading, int32_t actual, int32_t expected) {
+    if (actual != expected) {
+        printf("FAIL: %s(%u) = %d mm, expected %d mm\n", name, reading, actual, expected);
+        Test_Failures++;
+    }
+}
+
+int main(void) {
+    static const uint32_t readings[] = {16383, 16384, 20000, 0xFFFF, 0xFFFFFFFF};
+
+    Analog_Distance_Sensor_Init();
+
+    int32_t closest = Analog_Distance_Sensor_Calibrate(16383);
+
+    if (closest >= Analog_Distance_Sensor_Calibrate(0)) {
+        printf("FAIL: Analog_Distance_Sensor_Calibrate(16383) = %d mm is not closer than the reading 0\n", closest);
+        Test_Failures++;
+    }
+
+    for (uint32_t i = 0; i < sizeof(readings) / sizeof(readings[0]); i++) {
+        if (readings[i] <= 0xFFFF) {
+            Test_Expect_Equal("Analog_Distance_Sensor_Calibrate", readings[i],
+                              Analog_Distance_Sensor_Calibrate((int)readings[i]), closest);
+        }
+
+        for (int sensor = 0; sensor < ANALOG_DISTANCE_SENSOR_COUNT; sensor++) {
+            Test_Expect_Equal("Analog_Distance_Sensor_Convert", readings[i],
+                              Analog_Distance_Sensor_Convert((enum Analog_Distance_Sensor_Index)sensor, readings[i]), closest);
+        }
+    }
+
+    printf("%s\n", Test_Failures ? "analog distance sensors: FAILED" : "analog distance sensors: passed");
+
+    return Test_Failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file Test_Bumper_Switches.c
+ * @brief Host test of the bumper emergency stop for contacts that start inside a debounce window.
+ *
+ * The pin interrupts are disabled while a debounce window runs, so a second contact within the
+ * window is only seen when TIMER32_2 expires. The test releases a pressed bumper, which starts a
+ * window without stopping the motors, presses another bumper inside the window and checks that the
+ * motors are stopped when the window expires.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "inc/Clock.h"
+#include "inc/Motor.h"
+#include "inc/Bumper_Switches.h"
+
+// Interrupt handlers of the Bumper_Switches and Timer32_OneShot drivers
+void PORT4_IRQHandler(void);
+void T32_INT2_IRQHandler(void);
+
+// BUMP_0 (P4.0) and BUMP_2 (P4.3)
+#define TEST_BUMP_0_PIN 0x01
+#define TEST_BUMP_2_PIN 0x08
+
+static int Test_Failures;
+
+static void Test_Expect(const char *description, int condition) {
+    if (!condition) {
+        printf("FAIL: %s\n", description);
+        Test_Failures++;
+    }
+}
+
+/**
+ * @brief Changes the level of a bumper pin and sets its interrupt flag if the edge is selected.
+ */
+static void Test_Set_Pin(uint8_t pin, uint8_t pressed) {
+    uint8_t previous = P4->IN;
+
+    P4->IN = pressed ? (uint8_t)(P4->IN & ~pin) : (uint8_t)(P4->IN | pin);
+
+    // A falling edge sets the flag if IES selects it, a rising edge if it does not
+    if ((previous ^ P4->IN) & pin) {
+        if (((P4->IES & pin) != 0) == (pressed != 0)) {
+            P4->IFG |= pin;
+        }
+    }
+}
+
+/**
+ * @brief Runs the PORT4 interrupt handler if an enabled bumper flag is pending.
+ */
+static void Test_Dispatch_Port4(void) {
+    if (P4->IFG & P4->IE & BUMPER_PIN_MASK) {
+        PORT4_IRQHandler();
+    }
+}
+
+int main(void) {
+    Bumper_Event event;
+
+    Clock_Init48MHz();
+    Motor_Init();
+
+    // All switches released, with BUMP_0 pressed before the debounce state is taken
+    P4->IN = 0xFF & ~TEST_BUMP_0_PIN;
+
+    Bumper_Switches_Debounce_Init(NULL, 10000);
+    Bumper_Enable_Emergency_Stop(1);
+
+    // Releasing BUMP_0 starts a debounce window, but is not a contact
+    Test_Set_Pin(TEST_BUMP_0_PIN, 0);
+    Test_Dispatch_Port4();
+    Test_Expect("a release does not stop the motors", !Motor_Is_Emergency_Stopped());
+    Test_Expect("the pin interrupts are disabled during the window", (P4->IE & BUMPER_PIN_MASK) == 0);
+
+    // BUMP_2 is pressed inside the window, where its edge does not request an interrupt
+    Test_Set_Pin(TEST_BUMP_2_PIN, 1);
+    Test_Dispatch_Port4();
+    Test_Expect("no interrupt is handled inside the window", !Motor_Is_Emergency_Stopped());
+
+    // The window expires
+    T32_INT2_IRQHandler();
+
+    Test_Expect("a contact inside the window stops the motors", Motor_Is_Emergency_Stopped());
+    Test_Expect("the event of the window is queued", Bumper_Get_Event(&event));
+    Test_Expect("the event reports the new contact", (event.Pressed == 0x04) && (event.Released == 0x01));
+    Test_Expect("the pin interrupts are enabled again", (P4->IE & BUMPER_PIN_MASK) == BUMPER_PIN_MASK);
+
+    // A window that ends without a new contact does not stop the motors
+    Motor_Clear_Emergency_Stop();
+    Test_Set_Pin(TEST_BUMP_2_PIN, 0);
+    Test_Dispatch_Port4();
+    T32_INT2_IRQHandler();
+
+    Test_Expect("a release does not stop the motors at the end of the window", !Motor_Is_Emergency_Stopped());
+    Test_Expect("the release is queued", Bumper_Get_Event(&event) && (event.Released == 0x04));
+
+    printf("%s\n", Test_Failures ? "bumper switches: FAILED" : "bumper switches: passed");
+
+    return Test_Failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
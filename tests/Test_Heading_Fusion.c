@@ -0,0 +1,75 @@
+/**
+ * @file Test_Heading_Fusion.c
+ * @brief Host test of the heading fusion with gyroscope rates beyond the full-scale range.
+ *
+ * ExtractQ16() saturates a corrupted float to +/-GYRO_Q16_MAX, which main.c passes on as about
+ * +/-3.3e7 milliradians per second. The test feeds such values and the int32_t limits to
+ * Heading_Fusion_Set_Gyro_Rate() at the control rate and at 1 Hz, with the wheels standing still
+ * so that the bias is learned, and checks that they are limited to the full-scale range. In a
+ * MOTOR_SYSTEM_FUZZ build, the undefined behavior sanitizer also aborts on any overflow.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "inc/Clock.h"
+#include "inc/Tachometer.h"
+#include "inc/Odometry.h"
+#include "inc/GyroParser.h"
+#include "inc/Heading_Fusion.h"
+
+// Updates per scenario (5 s at 200 Hz)
+#define TEST_UPDATES 1000
+
+static int Test_Failures;
+
+static void Test_Expect(const char *description, int32_t z_rate, uint16_t rate_hz, int condition) {
+    if (!condition) {
+        printf("FAIL: %s (z rate %d, %u Hz)\n", description, z_rate, rate_hz);
+        Test_Failures++;
+    }
+}
+
+int main(void) {
+    // Largest Q16.16 magnitude converted to milliradians per second as in MotorControlFromGyro()
+    int32_t saturated = (int32_t)(((int64_t)GYRO_Q16_MAX * 1000) >> GYRO_Q16_SHIFT);
+
+    static const uint16_t rates_hz[] = {200, 1};
+    const int32_t z_rates[] = {INT32_MAX, INT32_MIN, saturated, -saturated};
+
+    Clock_Init48MHz();
+    Tachometer_Init();
+    Odometry_Init();
+
+    for (uint32_t r = 0; r < sizeof(rates_hz) / sizeof(rates_hz[0]); r++) {
+        for (uint32_t z = 0; z < sizeof(z_rates) / sizeof(z_rates[0]); z++) {
+            int32_t expected = (z_rates[z] > 0) ? HEADING_FUSION_MAX_GYRO_RATE : -HEADING_FUSION_MAX_GYRO_RATE;
+            Heading_Fusion_State state;
+
+            Heading_Fusion_Init(rates_hz[r]);
+            Heading_Fusion_Set_Gyro_Rate(z_rates[z]);
+            Heading_Fusion_Update();
+            Heading_Fusion_Get(&state);
+
+            Test_Expect("the gyroscope rate is limited to the full-scale range", z_rates[z], rates_hz[r],
+                        state.Gyro_Valid && (state.Gyro_Rate == expected));
+
+            for (uint32_t i = 0; i < TEST_UPDATES; i++) {
+                Heading_Fusion_Set_Gyro_Rate(z_rates[z]);
+                Heading_Fusion_Update();
+            }
+
+            Heading_Fusion_Get(&state);
+
+            Test_Expect("the bias stays within the full-scale range", z_rates[z], rates_hz[r],
+                        (state.Gyro_Bias >= -HEADING_FUSION_MAX_GYRO_RATE) && (state.Gyro_Bias <= HEADING_FUSION_MAX_GYRO_RATE));
+        }
+    }
+
+    printf("%s\n", Test_Failures ? "heading fusion: FAILED" : "heading fusion: passed");
+
+    return Test_Failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file Gyro_Stream_Tool.c
+ * @brief Host tool that generates and replays BLE gyroscope byte streams.
+ *
+ * Usage:
+ *
+ *   gyro_stream generate [options] [-o file]
+ *       Writes the raw bytes of a simulated Bluefruit Connect session to a file (or stdout).
+ *
+ *       -n, --packets N      number of packet periods (default 1000)
+ *       -r, --rate HZ        packets per second of the session (default 20)
+ *       -s, --seed N         seed of the generator (default 1)
+ *       -a, --amplitude A    peak tilt of the X and Y axes (default 1.0)
+ *           --noise SIGMA    standard deviation of the noise on each axis (default 0)
+ *           --loss P         lost packets, in permille
+ *           --truncate P     truncated packets, in permille
+ *           --bit-error P    packets with a flipped bit, in permille
+ *           --garbage P      packets preceded by random bytes, in permille
+ *           --burst N        consecutive packets affected by each impairment (default 1)
+ *
+ *   gyro_stream replay [-b baud | --unpaced] [-v] file
+ *       Feeds a recorded byte stream into the simulated EUSCI_A3 receiver, reads it back with
+ *       BLE_UART_InString() and validates each frame with the GyroParser. The bytes arrive at the
+ *       UART byte rate of the given baud rate (default 9600), or as fast as the receive FIFO accepts
+ *       them with --unpaced. With -v, every valid frame is passed to ParseBLEPacket().
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <setjmp.h>
+#include <getopt.h>
+#include <time.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "Gyro_Stream.h"
+#include "inc/Clock.h"
+#include "inc/BLE_UART.h"
+#include "inc/GyroParser.h"
+
+// Bits per UART character (start bit, 8 data bits and stop bit)
+#define GYRO_STREAM_BITS_PER_BYTE 10
+
+// Recorded stream being replayed
+static uint8_t *Replay_Data;
+static uint32_t Replay_Length;
+static uint32_t Replay_Offset;
+
+// Simulated cycles per received byte (0 to feed the bytes unpaced)
+static uint32_t Replay_Byte_Cycles;
+static uint64_t Replay_Next_Byte;
+
+static jmp_buf Replay_End;
+
+// Replay statistics (updated across longjmp)
+static uint32_t Replay_Frames;
+static uint32_t Replay_Valid;
+static uint32_t Replay_Invalid;
+
+static void Print_Usage(void) {
+    fprintf(stderr,
+            "usage: gyro_stream generate [-n packets] [-r rate] [-s seed] [-a amplitude] [--noise sigma]\n"
+            "                            [--loss permille] [--truncate permille] [--bit-error permille]\n"
+            "                            [--garbage permille] [--burst n] [-o file]\n"
+            "       gyro_stream replay [-b baud | --unpaced] [-v] file\n");
+}
+
+/**
+ * @brief Parses the rate of an impairment in permille.
+ *
+ * @return 1 if the whole text is a number from 0 to 1000, otherwise 0 after printing an error.
+ */
+static int Parse_Permille(const char *name, const char *text, uint16_t *permille) {
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+
+    // strtoul() skips leading spaces and accepts a sign, so require the text to start with a digit
+    if (!isdigit((unsigned char)text[0]) || (*end != '\0') || (value > 1000)) {
+        fprintf(stderr, "gyro_stream: --%s must be a number of permille from 0 to 1000, not '%s'\n", name, text);
+        return 0;
+    }
+
+    *permille = (uint16_t)value;
+    return 1;
+}
+
+/**
+ * @brief Feeds the recorded bytes into the EUSCI_A3 receive FIFO while the driver waits.
+ *
+ * Ends the replay once every byte has been received and read.
+ */
+static void Replay_Poll_Hook(void) {
+    if (Replay_Byte_Cycles == 0) {
+        Replay_Offset += HAL_Host_EUSCI_Feed(EUSCI_A3, &Replay_Data[Replay_Offset], Replay_Length - Replay_Offset);
+    } else {
+        while ((Replay_Offset < Replay_Length) && (HAL_Host_Get_Cycles() >= Replay_Next_Byte)) {
+            if (HAL_Host_EUSCI_Feed(EUSCI_A3, &Replay_Data[Replay_Offset], 1) == 0) {
+                break;
+            }
+
+            Replay_Offset++;
+            Replay_Next_Byte += Replay_Byte_Cycles;
+        }
+    }
+
+    if ((Replay_Offset == Replay_Length) && (HAL_Host_EUSCI_Pending(EUSCI_A3) == 0) && !(EUSCI_A3->IFG & 0x01)) {
+        longjmp(Replay_End, 1);
+    }
+}
+
+static void Replay_Stalled(void) {
+    longjmp(Replay_End, 1);
+}
+
+static int Generate(int argc, char **argv) {
+    static const struct option options[] = {
+        {"packets", required_argument, NULL, 'n'},
+        {"rate", required_argument, NULL, 'r'},
+        {"seed", required_argument, NULL, 's'},
+        {"amplitude", required_argument, NULL, 'a'},
+        {"output", required_argument, NULL, 'o'},
+        {"noise", required_argument, NULL, 1},
+        {"loss", required_argument, NULL, 2},
+        {"truncate", required_argument, NULL, 3},
+        {"bit-error", required_argument, NULL, 4},
+        {"garbage", required_argument, NULL, 5},
+        {"burst", required_argument, NULL, 6},
+        {NULL, 0, NULL, 0}
+    };
+
+    Gyro_Stream_Config config;
+    uint32_t packets = 1000;
+    const char *output = NULL;
+    int option;
+
+    Gyro_Stream_Default_Config(&config);
+
+    while ((option = getopt_long(argc, argv, "n:r:s:a:o:", options, NULL)) != -1) {
+        uint16_t *permille = NULL;
+        const char *name = NULL;
+
+        switch (option) {
+            case 'n': packets = strtoul(optarg, NULL, 0); break;
+            case 'r': config.Rate_Hz = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 's': config.Seed = strtoul(optarg, NULL, 0); break;
+            case 'a': config.Amplitude = strtof(optarg, NULL); break;
+            case 'o': output = optarg; break;
+            case 1: config.Noise = strtof(optarg, NULL); break;
+            case 2: permille = &config.Loss_Permille; name = "loss"; break;
+            case 3: permille = &config.Truncate_Permille; name = "truncate"; break;
+            case 4: permille = &config.Bit_Error_Permille; name = "bit-error"; break;
+            case 5: permille = &config.Garbage_Permille; name = "garbage"; break;
+            case 6: config.Burst_Length = (uint16_t)strtoul(optarg, NULL, 0); break;
+            default: Print_Usage(); return EXIT_FAILURE;
+        }
+
+        if ((permille != NULL) && !Parse_Permille(name, optarg, permille)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *file = (output != NULL) ? fopen(output, "wb") : stdout;
+
+    if (file == NULL) {
+        perror(output);
+        return EXIT_FAILURE;
+    }
+
+    Gyro_Stream stream;
+    uint8_t buffer[GYRO_STREAM_MAX_BYTES];
+    uint32_t bytes = 0;
+
+    Gyro_Stream_Init(&stream, &config);
+
+    for (uint32_t i = 0; i < packets; i++) {
+        uint32_t length = Gyro_Stream_Next(&stream, buffer);
+
+        fwrite(buffer, 1, length, file);
+        bytes += length;
+    }
+
+    if (file != stdout) {
+        fclose(file);
+    }
+
+    fprintf(stderr, "%u bytes: %u packets, %u lost, %u truncated, %u corrupted, %u garbage bytes\n",
+            bytes, stream.Packets, stream.Lost, stream.Truncated, stream.Corrupted, stream.Garbage_Bytes);
+
+    return EXIT_SUCCESS;
+}
+
+static int Replay(int argc, char **argv) {
+    static const struct option options[] = {
+        {"baud", required_argument, NULL, 'b'},
+        {"unpaced", no_argument, NULL, 'u'},
+        {"verbose", no_argument, NULL, 'v'},
+        {NULL, 0, NULL, 0}
+    };
+
+    uint32_t baud = 9600;
+    uint8_t verbose = 0;
+    int option;
+
+    while ((option = getopt_long(argc, argv, "b:uv", options, NULL)) != -1) {
+        switch (option) {
+            case 'b': baud = strtoul(optarg, NULL, 0); break;
+            case 'u': baud = 0; break;
+            case 'v': verbose = 1; break;
+            default: Print_Usage(); return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc) {
+        Print_Usage();
+        return EXIT_FAILURE;
+    }
+
+    FILE *file = fopen(argv[optind], "rb");
+
+    if (file == NULL) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    fseek(file, 0, SEEK_END);
+    Replay_Length = (uint32_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    Replay_Data = malloc(Replay_Length ? Replay_Length : 1);
+
+    if (fread(Replay_Data, 1, Replay_Length, file) != Replay_Length) {
+        perror(argv[optind]);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    fclose(file);
+
+    Clock_Init48MHz();
+    BLE_UART_Init();
+
+    Replay_Offset = 0;
+    Replay_Byte_Cycles = (baud != 0) ? (Clock_GetFreq() / baud) * GYRO_STREAM_BITS_PER_BYTE : 0;
+    Replay_Next_Byte = HAL_Host_Get_Cycles() + Replay_Byte_Cycles;
+
+    HAL_Host_Set_Poll_Hook(Replay_Poll_Hook);
+    HAL_Host_Set_Stall_Handler(Replay_Stalled);
+
+    uint64_t start_cycles = HAL_Host_Get_Cycles();
+    struct timespec start_time;
+    struct timespec end_time;
+    static char buffer[BLE_UART_BUFFER_SIZE];
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    if (setjmp(Replay_End) == 0) {
+        for (;;) {
+            int length = BLE_UART_InString(buffer, BLE_UART_BUFFER_SIZE);
+
+            Replay_Frames++;
+
+            if (ValidateBLEPacket((uint8_t *)buffer, (uint16_t)length)) {
+                Replay_Valid++;
+
+                if (verbose) {
+                    ParseBLEPacket((uint8_t *)buffer, (uint16_t)length);
+                }
+            } else {
+                Replay_Invalid++;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    double host_seconds = (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) * 1e-9;
+    double simulated_seconds = (double)(HAL_Host_Get_Cycles() - start_cycles) / (double)Clock_GetFreq();
+
+    printf("bytes:           %u\n", Replay_Length);
+    printf("frames:          %u (%u valid, %u invalid)\n", Replay_Frames, Replay_Valid, Replay_Invalid);
+    printf("simulated time:  %.3f s\n", simulated_seconds);
+    printf("host time:       %.3f s (%.0f bytes/s)\n", host_seconds, (host_seconds > 0.0) ? (double)Replay_Length / host_seconds : 0.0);
+
+    free(Replay_Data);
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        Print_Usage();
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[1], "generate") == 0) {
+        return Generate(argc - 1, argv + 1);
+    }
+
+    if (strcmp(argv[1], "replay") == 0) {
+        return Replay(argc - 1, argv + 1);
+    }
+
+    Print_Usage();
+    return EXIT_FAILURE;
+}
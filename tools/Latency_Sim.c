@@ -0,0 +1,340 @@
+/**
+ * @file Latency_Sim.c
+ * @brief Host simulation of the packet-to-motor latency of the application in main.c.
+ *
+ * Usage:
+ *
+ *   latency_sim [-n packets] [-r rate] [-s seed] [--noise sigma] [--loss p] [--garbage p] [--max-latency us] [-v]
+ *
+ *       -n, --packets N       number of packet periods of the session (default 600)
+ *       -r, --rate HZ         packets per second (default 20)
+ *       -s, --seed N          seed of the session (default 1)
+ *           --noise SIGMA     noise on each axis (default 0)
+ *           --loss P          lost packets, in permille
+ *           --garbage P       packets preceded by random bytes, in permille
+ *           --max-latency US  fails if no packet reached the motors, or if the longest latency is
+ *                             above US microseconds
+ *       -v, --verbose         prints the serial console output of the application
+ *
+ * The unmodified application (main.c, built with its main() renamed to Application_Main()) runs
+ * against the simulated register file. Once it has sent its ready message to the BLE module, a
+ * generated Bluefruit Connect session arrives on EUSCI_A3: each packet starts at the packet rate
+ * and its bytes follow at the baud rate set by BLE_UART_Init(). The simulation provides what the
+ * hardware would do in the meantime:
+ *
+ *  - The Timer_A1 interrupt is dispatched at its period whenever interrupts are enabled, so the
+ *    control loop runs while the main loop waits or prints.
+ *
+ *  - Every byte written to EUSCI_A0 takes the time of one character at the baud rate set by
+ *    EUSCI_A0_UART_Init(), including printf() output, which is redirected to EUSCI_A0 as on the
+ *    target. The cost of the debug output is therefore part of the measured latency.
+ *
+ * Once the session has been received, the histogram collected by the Latency driver is printed
+ * with Latency_Print_Histogram(), i.e. in the same format as on the serial console of the robot.
+ * With --max-latency, the exit status is EXIT_FAILURE if the histogram exceeds the limit, so that
+ * the simulation can run as a regression test.
+ *
+ * @note The wheels are not simulated, so the heading estimate only follows the gyroscope.
+ *
+ * @author Nainika Saha
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "Gyro_Stream.h"
+#include "inc/EUSCI_A0_UART.h"
+#include "inc/Latency.h"
+
+// Bits per UART character (start bit, 8 data bits and stop bit)
+#define SIM_BITS_PER_BYTE 10
+
+// Time the simulation keeps running after the last byte, so that the last packet reaches the motors (MCLK cycles)
+#define SIM_DRAIN_CYCLES (48000000 / 20)
+
+// Entry point of main.c, renamed when it is built for the simulation
+int Application_Main(void);
+
+// Interrupt handler of the Timer_A1_Interrupt driver
+void TA1_0_IRQHandler(void);
+
+// Session being received, with the offset of the first byte of each packet period
+static uint8_t *Sim_Data;
+static uint32_t Sim_Length;
+static uint32_t Sim_Offset;
+static uint32_t *Sim_Packet_Offsets;
+static uint32_t Sim_Packets;
+static uint32_t Sim_Packet;
+static uint64_t Sim_Packet_Cycles;
+
+// Start of the session (0 until the application is ready) and earliest time of the next byte
+static uint64_t Sim_Start;
+static uint64_t Sim_Next_Byte;
+
+// Next Timer_A1 interrupt (0 until the timer is enabled)
+static uint64_t Sim_Next_Control;
+
+// Time at which the simulation ends (0 until every byte has been read)
+static uint64_t Sim_End_Cycle;
+
+// Set while the application writes to EUSCI_A0 or runs the Timer_A1 interrupt
+static uint8_t Sim_In_Output;
+static uint8_t Sim_In_Interrupt;
+
+// Set when the last byte sent to the BLE module ended a line
+static uint8_t Sim_Ready;
+
+static uint8_t Sim_Verbose;
+static FILE *Sim_Report;
+static jmp_buf Sim_End;
+
+/**
+ * @brief Returns the MCLK cycles per character of a UART, or 0 if its baud rate is not set.
+ */
+static uint32_t Sim_Byte_Cycles(EUSCI_A_Type *module) {
+    // BRW divides SMCLK (MCLK / 4) without oversampling
+    return (uint32_t)module->BRW * 4 * SIM_BITS_PER_BYTE;
+}
+
+/**
+ * @brief Models the UART, Timer_A1 and the end of the session while the application waits.
+ */
+static void Sim_Poll_Hook(void) {
+    uint64_t now = HAL_Host_Get_Cycles();
+    uint32_t byte_cycles = Sim_Byte_Cycles(EUSCI_A3);
+
+    // The session starts on the first poll after the application has sent its ready message
+    if ((Sim_Start == 0) && Sim_Ready && (byte_cycles != 0)) {
+        Sim_Start = now;
+        Sim_Next_Byte = now;
+    }
+
+    // Each byte arrives on P9.6 one character time after the previous byte, and not before its packet period
+    while ((Sim_Start != 0) && (Sim_Offset < Sim_Length)) {
+        while ((Sim_Packet + 1 < Sim_Packets) && (Sim_Offset >= Sim_Packet_Offsets[Sim_Packet + 1])) {
+            Sim_Packet++;
+        }
+
+        uint64_t packet_start = Sim_Start + Sim_Packet * Sim_Packet_Cycles;
+        uint64_t arrival = ((Sim_Next_Byte > packet_start) ? Sim_Next_Byte : packet_start) + byte_cycles;
+
+        if ((now < arrival) || (HAL_Host_EUSCI_Feed(EUSCI_A3, &Sim_Data[Sim_Offset], 1) == 0)) {
+            break;
+        }
+
+        Sim_Offset++;
+        Sim_Next_Byte = arrival;
+    }
+
+    // Timer_A1 interrupt, while the timer runs, CCIE is set, IRQ 10 is enabled and PRIMASK is clear
+    if ((TIMER_A1->CTL & 0x0030) && (TIMER_A1->CCTL[0] & 0x0010) && (NVIC->ISER[0] & 0x00000400) &&
+        !HAL_Host_PRIMASK && !Sim_In_Interrupt) {
+        uint64_t period = ((uint64_t)TIMER_A1->CCR[0] + 1) * 4;
+
+        if (Sim_Next_Control == 0) {
+            Sim_Next_Control = now + period;
+        }
+
+        while (now >= Sim_Next_Control) {
+            Sim_In_Interrupt = 1;
+            TIMER_A1->CCTL[0] |= 0x0001;
+            TA1_0_IRQHandler();
+            Sim_In_Interrupt = 0;
+            Sim_Next_Control += period;
+        }
+    }
+
+    // End once every byte has been read and the last packet has had time to reach the motors
+    if ((Sim_Start != 0) && (Sim_Offset == Sim_Length) && (HAL_Host_EUSCI_Pending(EUSCI_A3) == 0) && !(EUSCI_A3->IFG & 0x01)) {
+        if (Sim_End_Cycle == 0) {
+            Sim_End_Cycle = now + SIM_DRAIN_CYCLES;
+        } else if ((now >= Sim_End_Cycle) && !Sim_In_Output && !Sim_In_Interrupt) {
+            longjmp(Sim_End, 1);
+        }
+    }
+}
+
+/**
+ * @brief Lets the simulation run for the duration of each character written to EUSCI_A0.
+ */
+static void Sim_Console_Output(uint8_t data) {
+    uint32_t polls = Sim_Byte_Cycles(EUSCI_A0) / HAL_HOST_POLL_CYCLES;
+
+    if (Sim_Verbose) {
+        fputc(data, Sim_Report);
+    }
+
+    Sim_In_Output++;
+
+    for (uint32_t i = 0; i < polls; i++) {
+        HAL_Host_Poll();
+    }
+
+    Sim_In_Output--;
+}
+
+/**
+ * @brief Watches for the end of the ready message that the application sends to the BLE module.
+ */
+static void Sim_BLE_Output(uint8_t data) {
+    Sim_Ready = (data == '\n');
+}
+
+/**
+ * @brief Prints the output of Latency_Print_Histogram() without the carriage returns.
+ */
+static void Sim_Report_Output(uint8_t data) {
+    if (data != '\r') {
+        fputc(data, Sim_Report);
+    }
+}
+
+/**
+ * @brief Sends printf() output to EUSCI_A0, as EUSCI_A0_UART_Init_Printf() does on the target.
+ */
+static ssize_t Sim_Stdout_Write(void *cookie, const char *buffer, size_t size) {
+    return EUSCI_A0_UART_Write(0, buffer, (unsigned)size);
+}
+
+static void Sim_Stalled(void) {
+    if (!Sim_In_Output && !Sim_In_Interrupt) {
+        longjmp(Sim_End, 1);
+    }
+}
+
+static void Print_Usage(void) {
+    fprintf(stderr, "usage: latency_sim [-n packets] [-r rate] [-s seed] [--noise sigma] [--loss p] [--garbage p]\n"
+                    "                   [--max-latency us] [-v]\n");
+}
+
+int main(int argc, char **argv) {
+    static const struct option options[] = {
+        {"packets", required_argument, NULL, 'n'},
+        {"rate", required_argument, NULL, 'r'},
+        {"seed", required_argument, NULL, 's'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"noise", required_argument, NULL, 1},
+        {"loss", required_argument, NULL, 2},
+        {"garbage", required_argument, NULL, 3},
+        {"max-latency", required_argument, NULL, 4},
+        {NULL, 0, NULL, 0}
+    };
+
+    Gyro_Stream_Config config;
+    uint32_t packets = 600;
+    uint32_t max_latency_us = 0;
+    int option;
+
+    Gyro_Stream_Default_Config(&config);
+
+    while ((option = getopt_long(argc, argv, "n:r:s:v", options, NULL)) != -1) {
+        switch (option) {
+            case 'n': packets = strtoul(optarg, NULL, 0); break;
+            case 'r': config.Rate_Hz = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 's': config.Seed = strtoul(optarg, NULL, 0); break;
+            case 'v': Sim_Verbose = 1; break;
+            case 1: config.Noise = strtof(optarg, NULL); break;
+            case 2: config.Loss_Permille = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 3: config.Garbage_Permille = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 4: max_latency_us = strtoul(optarg, NULL, 0); break;
+            default: Print_Usage(); return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc) {
+        Print_Usage();
+        return EXIT_FAILURE;
+    }
+
+    // Generate the session, with silence between the packets at the packet rate
+    Gyro_Stream stream;
+    uint32_t capacity = packets * GYRO_STREAM_MAX_BYTES;
+
+    Gyro_Stream_Init(&stream, &config);
+    Sim_Data = malloc(capacity ? capacity : 1);
+    Sim_Packet_Offsets = malloc((packets ? packets : 1) * sizeof(uint32_t));
+    Sim_Packet_Cycles = 48000000 / stream.Config.Rate_Hz;
+    Sim_Packets = packets;
+    Sim_Length = 0;
+
+    if ((Sim_Data == NULL) || (Sim_Packet_Offsets == NULL)) {
+        fprintf(stderr, "latency_sim: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < packets; i++) {
+        Sim_Packet_Offsets[i] = Sim_Length;
+        Sim_Length += Gyro_Stream_Next(&stream, &Sim_Data[Sim_Length]);
+    }
+
+    // The report goes to the original standard output, and printf() of the application to EUSCI_A0
+    static const cookie_io_functions_t console = {NULL, Sim_Stdout_Write, NULL, NULL};
+
+    Sim_Report = fdopen(dup(STDOUT_FILENO), "w");
+    fflush(stdout);
+    stdout = fopencookie(NULL, "w", console);
+
+    if ((Sim_Report == NULL) || (stdout == NULL)) {
+        fprintf(stderr, "latency_sim: cannot redirect the standard output\n");
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    HAL_Host_Set_Poll_Hook(Sim_Poll_Hook);
+    HAL_Host_Set_Stall_Handler(Sim_Stalled);
+    HAL_Host_Set_TX_Handler(EUSCI_A0, Sim_Console_Output);
+    HAL_Host_Set_TX_Handler(EUSCI_A3, Sim_BLE_Output);
+
+    struct timespec start_time;
+    struct timespec end_time;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    if (setjmp(Sim_End) == 0) {
+        Application_Main();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    double host_seconds = (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) * 1e-9;
+    double simulated_seconds = (double)(HAL_Host_Get_Cycles() - Sim_Start) / 48e6;
+
+    // Stop the simulation before printing the report, since the drivers poll while they write
+    HAL_Host_Set_Poll_Hook(NULL);
+    HAL_Host_Set_Stall_Handler(NULL);
+
+    fprintf(Sim_Report, "session:         %u bytes, %u packets (%u lost, %u garbage bytes)\n",
+            Sim_Length, stream.Packets, stream.Lost, stream.Garbage_Bytes);
+    fprintf(Sim_Report, "simulated time:  %.3f s\n", simulated_seconds);
+    fprintf(Sim_Report, "host time:       %.3f s\n", host_seconds);
+
+    // Print the histogram through the same path as on the robot
+    HAL_Host_Set_TX_Handler(EUSCI_A0, Sim_Report_Output);
+    Latency_Print_Histogram();
+
+    Latency_Histogram histogram;
+    int status = EXIT_SUCCESS;
+
+    Latency_Get_Histogram(&histogram);
+
+    if ((max_latency_us != 0) && ((histogram.Count == 0) || (histogram.Max_us > max_latency_us))) {
+        fprintf(Sim_Report, "FAIL: longest latency %u us, limit %u us (%u packets)\n",
+                histogram.Max_us, max_latency_us, histogram.Count);
+        status = EXIT_FAILURE;
+    }
+
+    fclose(Sim_Report);
+    free(Sim_Data);
+    free(Sim_Packet_Offsets);
+
+    return status;
+}
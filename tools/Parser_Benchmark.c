@@ -0,0 +1,286 @@
+/**
+ * @file Parser_Benchmark.c
+ * @brief Host benchmark for the BLE framing and gyroscope packet parsing.
+ *
+ * Usage:
+ *
+ *   parser_benchmark [-n bytes] [-s seed] [scenario...]
+ *
+ *       -n, --bytes N   bytes generated for each scenario (default 4000000)
+ *       -s, --seed N    seed of the stream generator (default 1)
+ *
+ *   Scenarios (all by default):
+ *
+ *       clean    valid packets only
+ *       noisy    noise on every axis, 2% bit errors and 2% truncated packets
+ *       desync   10% of the packets preceded by random bytes, 5% truncated and 5% lost, in bursts of 3
+ *
+ * Each scenario is measured twice:
+ *
+ *  - receive: the stream is fed unpaced into the simulated EUSCI_A3 receiver and every frame is read
+ *    with BLE_UART_InString(), then validated with ValidateBLEPacket() and decoded with ExtractQ16().
+ *    The latency of a frame is the host time from calling BLE_UART_InString() to the decoded values,
+ *    and includes the cost of the simulated UART.
+ *
+ *  - parse: the frames captured by the receive run are validated and decoded again from memory,
+ *    which isolates the cost of the GyroParser.
+ *
+ * The results report bytes/s, frames/s and the 50th, 90th, 99th and 99.9th percentile and maximum
+ * frame latency in nanoseconds.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <getopt.h>
+#include <time.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "Gyro_Stream.h"
+#include "inc/Clock.h"
+#include "inc/BLE_UART.h"
+#include "inc/GyroParser.h"
+
+typedef struct {
+    const char *Name;
+    float Noise;
+    uint16_t Loss_Permille;
+    uint16_t Truncate_Permille;
+    uint16_t Bit_Error_Permille;
+    uint16_t Garbage_Permille;
+    uint16_t Burst_Length;
+} Benchmark_Scenario;
+
+static const Benchmark_Scenario Benchmark_Scenarios[] = {
+    {"clean", 0.0f, 0, 0, 0, 0, 1},
+    {"noisy", 0.05f, 0, 20, 20, 0, 1},
+    {"desync", 0.05f, 50, 50, 0, 100, 3},
+};
+
+#define BENCHMARK_SCENARIO_COUNT (sizeof(Benchmark_Scenarios) / sizeof(Benchmark_Scenarios[0]))
+
+// Stream being fed into the simulated receiver
+static uint8_t *Benchmark_Data;
+static uint32_t Benchmark_Length;
+static uint32_t Benchmark_Offset;
+
+static jmp_buf Benchmark_End;
+
+// Frames captured by the receive run (updated across longjmp)
+static uint8_t (*Benchmark_Frames)[GYRO_STREAM_PACKET_SIZE];
+static uint32_t *Benchmark_Frame_Lengths;
+static uint64_t *Benchmark_Latencies;
+static uint32_t Benchmark_Frame_Count;
+static uint32_t Benchmark_Frame_Capacity;
+
+// Sum of the decoded values, printed so that the decoding cannot be optimized away
+static volatile uint32_t Benchmark_Checksum;
+
+static uint64_t Benchmark_Now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static int Benchmark_Compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Feeds the stream into the EUSCI_A3 receive FIFO and ends the run once it has been read.
+ */
+static void Benchmark_Poll_Hook(void) {
+    Benchmark_Offset += HAL_Host_EUSCI_Feed(EUSCI_A3, &Benchmark_Data[Benchmark_Offset], Benchmark_Length - Benchmark_Offset);
+
+    if ((Benchmark_Offset == Benchmark_Length) && (HAL_Host_EUSCI_Pending(EUSCI_A3) == 0) && !(EUSCI_A3->IFG & 0x01)) {
+        longjmp(Benchmark_End, 1);
+    }
+}
+
+static void Benchmark_Stalled(void) {
+    longjmp(Benchmark_End, 1);
+}
+
+/**
+ * @brief Validates and decodes one frame the same way as the application.
+ *
+ * @return 1 if the frame is a valid packet, 0 otherwise.
+ */
+static uint8_t Benchmark_Parse(uint8_t *frame, uint32_t length) {
+    if (!ValidateBLEPacket(frame, (uint16_t)length)) {
+        return 0;
+    }
+
+    Benchmark_Checksum += (uint32_t)ExtractQ16(frame, 2) + (uint32_t)ExtractQ16(frame, 6) + (uint32_t)ExtractQ16(frame, 10);
+    return 1;
+}
+
+/**
+ * @brief Sorts the latencies and prints the throughput and the latency percentiles.
+ */
+static void Benchmark_Report(const char *name, const char *stage, uint64_t bytes, uint32_t frames,
+                             uint32_t valid, uint64_t elapsed_ns, uint64_t *latencies) {
+    double seconds = (double)elapsed_ns * 1e-9;
+
+    qsort(latencies, frames, sizeof(uint64_t), Benchmark_Compare);
+
+    uint64_t p50 = frames ? latencies[(uint64_t)frames * 500 / 1000] : 0;
+    uint64_t p90 = frames ? latencies[(uint64_t)frames * 900 / 1000] : 0;
+    uint64_t p99 = frames ? latencies[(uint64_t)frames * 990 / 1000] : 0;
+    uint64_t p999 = frames ? latencies[(uint64_t)frames * 999 / 1000] : 0;
+    uint64_t max = frames ? latencies[frames - 1] : 0;
+
+    printf("%-7s %-8s %10.0f %11.0f %8u %8u %7llu %7llu %7llu %7llu %8llu\n",
+           name, stage,
+           (seconds > 0.0) ? (double)bytes / seconds : 0.0,
+           (seconds > 0.0) ? (double)frames / seconds : 0.0,
+           frames, valid,
+           (unsigned long long)p50, (unsigned long long)p90, (unsigned long long)p99,
+           (unsigned long long)p999, (unsigned long long)max);
+}
+
+static void Benchmark_Run(const Benchmark_Scenario *scenario, uint32_t bytes, uint32_t seed) {
+    Gyro_Stream_Config config;
+    Gyro_Stream stream;
+
+    Gyro_Stream_Default_Config(&config);
+    config.Seed = seed;
+    config.Noise = scenario->Noise;
+    config.Loss_Permille = scenario->Loss_Permille;
+    config.Truncate_Permille = scenario->Truncate_Permille;
+    config.Bit_Error_Permille = scenario->Bit_Error_Permille;
+    config.Garbage_Permille = scenario->Garbage_Permille;
+    config.Burst_Length = scenario->Burst_Length;
+    Gyro_Stream_Init(&stream, &config);
+
+    // Generate the stream
+    Benchmark_Length = 0;
+
+    while (Benchmark_Length + GYRO_STREAM_MAX_BYTES <= bytes) {
+        Benchmark_Length += Gyro_Stream_Next(&stream, &Benchmark_Data[Benchmark_Length]);
+    }
+
+    // Receive run
+    HAL_Host_Reset();
+    Clock_Init48MHz();
+    BLE_UART_Init();
+    HAL_Host_Set_Poll_Hook(Benchmark_Poll_Hook);
+    HAL_Host_Set_Stall_Handler(Benchmark_Stalled);
+
+    Benchmark_Offset = 0;
+    Benchmark_Frame_Count = 0;
+
+    uint32_t valid = 0;
+    uint64_t start = Benchmark_Now_ns();
+
+    if (setjmp(Benchmark_End) == 0) {
+        while (Benchmark_Frame_Count < Benchmark_Frame_Capacity) {
+            uint8_t *frame = Benchmark_Frames[Benchmark_Frame_Count];
+            char buffer[BLE_UART_BUFFER_SIZE];
+            uint64_t frame_start = Benchmark_Now_ns();
+
+            int length = BLE_UART_InString(buffer, BLE_UART_BUFFER_SIZE);
+            Benchmark_Parse((uint8_t *)buffer, (uint32_t)length);
+
+            Benchmark_Latencies[Benchmark_Frame_Count] = Benchmark_Now_ns() - frame_start;
+
+            memcpy(frame, buffer, GYRO_STREAM_PACKET_SIZE);
+            Benchmark_Frame_Lengths[Benchmark_Frame_Count] = (uint32_t)length;
+            Benchmark_Frame_Count++;
+        }
+    }
+
+    uint64_t elapsed = Benchmark_Now_ns() - start;
+
+    for (uint32_t i = 0; i < Benchmark_Frame_Count; i++) {
+        valid += ValidateBLEPacket(Benchmark_Frames[i], (uint16_t)Benchmark_Frame_Lengths[i]);
+    }
+
+    Benchmark_Report(scenario->Name, "receive", Benchmark_Length, Benchmark_Frame_Count, valid, elapsed, Benchmark_Latencies);
+
+    // Parse run over the captured frames
+    valid = 0;
+    start = Benchmark_Now_ns();
+
+    for (uint32_t i = 0; i < Benchmark_Frame_Count; i++) {
+        uint64_t frame_start = Benchmark_Now_ns();
+
+        valid += Benchmark_Parse(Benchmark_Frames[i], Benchmark_Frame_Lengths[i]);
+        Benchmark_Latencies[i] = Benchmark_Now_ns() - frame_start;
+    }
+
+    elapsed = Benchmark_Now_ns() - start;
+
+    Benchmark_Report(scenario->Name, "parse", (uint64_t)Benchmark_Frame_Count * GYRO_STREAM_PACKET_SIZE,
+                     Benchmark_Frame_Count, valid, elapsed, Benchmark_Latencies);
+}
+
+int main(int argc, char **argv) {
+    static const struct option options[] = {
+        {"bytes", required_argument, NULL, 'n'},
+        {"seed", required_argument, NULL, 's'},
+        {NULL, 0, NULL, 0}
+    };
+
+    uint32_t bytes = 4000000;
+    uint32_t seed = 1;
+    int option;
+
+    while ((option = getopt_long(argc, argv, "n:s:", options, NULL)) != -1) {
+        switch (option) {
+            case 'n': bytes = strtoul(optarg, NULL, 0); break;
+            case 's': seed = strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: parser_benchmark [-n bytes] [-s seed] [clean] [noisy] [desync]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (bytes < GYRO_STREAM_MAX_BYTES) {
+        bytes = GYRO_STREAM_MAX_BYTES;
+    }
+
+    // BLE_UART_InString() only returns once it has collected a full packet, so every frame takes at least 15 bytes
+    Benchmark_Data = malloc(bytes);
+    Benchmark_Frame_Capacity = bytes / GYRO_STREAM_PACKET_SIZE + 1;
+    Benchmark_Frames = malloc((size_t)Benchmark_Frame_Capacity * GYRO_STREAM_PACKET_SIZE);
+    Benchmark_Frame_Lengths = malloc((size_t)Benchmark_Frame_Capacity * sizeof(uint32_t));
+    Benchmark_Latencies = malloc((size_t)Benchmark_Frame_Capacity * sizeof(uint64_t));
+
+    if (!Benchmark_Data || !Benchmark_Frames || !Benchmark_Frame_Lengths || !Benchmark_Latencies) {
+        fprintf(stderr, "parser_benchmark: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-7s %-8s %10s %11s %8s %8s %7s %7s %7s %7s %8s\n",
+           "stream", "stage", "bytes/s", "frames/s", "frames", "valid", "p50 ns", "p90 ns", "p99 ns", "p99.9", "max ns");
+
+    for (uint32_t i = 0; i < BENCHMARK_SCENARIO_COUNT; i++) {
+        uint8_t selected = (optind >= argc);
+
+        for (int j = optind; j < argc; j++) {
+            selected |= (strcmp(argv[j], Benchmark_Scenarios[i].Name) == 0);
+        }
+
+        if (selected) {
+            Benchmark_Run(&Benchmark_Scenarios[i], bytes, seed);
+        }
+    }
+
+    printf("checksum: %08lx\n", (unsigned long)Benchmark_Checksum);
+
+    free(Benchmark_Data);
+    free(Benchmark_Frames);
+    free(Benchmark_Frame_Lengths);
+    free(Benchmark_Latencies);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,412 @@
+/**
+ * @file Plant_Sim.c
+ * @brief Host closed-loop simulation of the motors, encoders, odometry and heading hold.
+ *
+ * Usage:
+ *
+ *   plant_sim [options] step|hold
+ *
+ *       -d, --duty D          duty cycle of both motors out of 15000 (default 4000)
+ *       -T, --time S          simulated seconds (default 5)
+ *           --left-gain G     torque scale of the left motor (default 1.0 for step, 0.9 for hold)
+ *           --right-gain G    torque scale of the right motor (default 1.0)
+ *           --kp K            proportional gain of the heading hold (default 5)
+ *           --ki-shift N      integral gain of the heading hold as a shift (default 6)
+ *           --gyro-noise N    standard deviation of the gyroscope Z rate (mrad/s, default 0)
+ *           --gyro-bias B     bias of the gyroscope Z rate (mrad/s, default 0)
+ *       -s, --seed N          seed of the gyroscope noise (default 1)
+ *       -t, --trace FILE      writes the state at every control period as CSV
+ *           --max-odometry-error MM
+ *                             fails if the final odometry position error is above MM millimeters
+ *           --max-fused-error DEG
+ *                             fails if the rms error of the fused heading is above DEG degrees (hold)
+ *
+ *   Scenarios:
+ *
+ *       step    open loop: both motors forward at the duty cycle for the first 80% of the time,
+ *               then stopped. Reports the wheel speed response, the Tachometer speed and the
+ *               odometry error.
+ *
+ *       hold    closed loop: drives forward at the duty cycle while a PI controller corrects the
+ *               left and right duty cycles from the fused heading, with the same control law as
+ *               Control_Task() in main.c. Reports the heading error and the lateral drift.
+ *
+ * The drivers run unmodified against the simulated register file. host/Plant_Model.c converts the
+ * Timer_A0 duty cycles and the direction pins into wheel motion and encoder edges, and the Timer_A1
+ * interrupt runs the control task at 200 Hz. The gyroscope Z rate is the yaw rate of the platform,
+ * sent to Heading_Fusion at the 20 Hz rate of the Bluefruit Connect app.
+ *
+ * With a --max option, the exit status is EXIT_FAILURE if the result exceeds the limit, so that the
+ * simulation can run as a regression test.
+ *
+ * @author Nainika Saha
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <time.h>
+#include "msp.h"
+#include "HAL_Host.h"
+#include "Plant_Model.h"
+#include "inc/Clock.h"
+#include "inc/Motor.h"
+#include "inc/Tachometer.h"
+#include "inc/Odometry.h"
+#include "inc/Heading_Fusion.h"
+#include "inc/Timer_A1_Interrupt.h"
+
+#define SIM_PI 3.14159265358979323846
+
+// Control loop rate and period, as in main.c
+#define SIM_CONTROL_RATE_HZ 200
+#define SIM_CONTROL_TIMER_PERIOD (12000000 / SIM_CONTROL_RATE_HZ)
+#define SIM_CONTROL_CYCLES (SIM_CONTROL_TIMER_PERIOD * PLANT_MODEL_SMCLK_DIVIDER)
+
+// Control periods between gyroscope samples (20 Hz)
+#define SIM_GYRO_DIVIDER 10
+
+// Control periods over which the wheel speeds are averaged (0.5 s)
+#define SIM_AVERAGE_PERIODS 100
+
+// Duty cycle limits of the heading hold, as in main.c
+#define SIM_DUTY_LIMIT 14000
+#define SIM_MAX_CORRECTION 1500
+
+// Interrupt handler of the Timer_A1_Interrupt driver
+void TA1_0_IRQHandler(void);
+
+// Parameters of the run
+static uint8_t Sim_Hold;
+static uint16_t Sim_Duty = 4000;
+static int32_t Sim_Kp = 5;
+static int32_t Sim_Ki_Shift = 6;
+static double Sim_Gyro_Noise;
+static double Sim_Gyro_Bias;
+static uint32_t Sim_Random = 1;
+
+// State of the control task
+static uint8_t Sim_Driving;
+static uint32_t Sim_Target;
+static int32_t Sim_Integral;
+
+/**
+ * @brief Returns approximately normally distributed noise with a standard deviation of 1.
+ */
+static double Sim_Noise(void) {
+    double sum = 0.0;
+
+    for (int i = 0; i < 4; i++) {
+        Sim_Random ^= Sim_Random << 13;
+        Sim_Random ^= Sim_Random >> 17;
+        Sim_Random ^= Sim_Random << 5;
+        sum += (double)(Sim_Random >> 8) / 16777216.0;
+    }
+
+    return (sum - 2.0) * 1.7320508;
+}
+
+/**
+ * @brief Converts a binary angle difference to radians.
+ */
+static double Sim_Binary_Angle_To_Radians(uint32_t angle) {
+    return (double)(int32_t)angle * (2.0 * SIM_PI / 4294967296.0);
+}
+
+/**
+ * @brief Runs at 200 Hz from the Timer_A1 interrupt.
+ *
+ * Updates the odometry and the fused heading and, in the hold scenario, applies the PI correction
+ * of Control_Task() in main.c to the left and right duty cycles.
+ */
+static void Sim_Control_Task(void) {
+    Odometry_Update();
+    Heading_Fusion_Update();
+
+    if (!Sim_Hold || !Sim_Driving) {
+        return;
+    }
+
+    Heading_Fusion_State heading;
+    Heading_Fusion_Get(&heading);
+
+    int32_t error = (int32_t)(Sim_Target - heading.Heading) / HEADING_FUSION_BINARY_ANGLE_PER_MRAD;
+
+    Sim_Integral += error;
+    if (Sim_Integral > (SIM_MAX_CORRECTION << Sim_Ki_Shift)) {
+        Sim_Integral = (SIM_MAX_CORRECTION << Sim_Ki_Shift);
+    } else if (Sim_Integral < -(SIM_MAX_CORRECTION << Sim_Ki_Shift)) {
+        Sim_Integral = -(SIM_MAX_CORRECTION << Sim_Ki_Shift);
+    }
+
+    int32_t correction = (Sim_Kp * error) + (Sim_Integral >> Sim_Ki_Shift);
+    if (correction > SIM_MAX_CORRECTION) {
+        correction = SIM_MAX_CORRECTION;
+    } else if (correction < -SIM_MAX_CORRECTION) {
+        correction = -SIM_MAX_CORRECTION;
+    }
+
+    int32_t left = (int32_t)Sim_Duty - correction;
+    int32_t right = (int32_t)Sim_Duty + correction;
+
+    left = (left < 0) ? 0 : ((left > SIM_DUTY_LIMIT) ? SIM_DUTY_LIMIT : left);
+    right = (right < 0) ? 0 : ((right > SIM_DUTY_LIMIT) ? SIM_DUTY_LIMIT : right);
+
+    Motor_Forward((uint16_t)left, (uint16_t)right);
+}
+
+static void Print_Usage(void) {
+    fprintf(stderr,
+            "usage: plant_sim [-d duty] [-T seconds] [--left-gain g] [--right-gain g] [--kp k] [--ki-shift n]\n"
+            "                 [--gyro-noise n] [--gyro-bias b] [-s seed] [-t trace.csv] [--max-odometry-error mm]\n"
+            "                 [--max-fused-error deg] step|hold\n");
+}
+
+int main(int argc, char **argv) {
+    static const struct option options[] = {
+        {"duty", required_argument, NULL, 'd'},
+        {"time", required_argument, NULL, 'T'},
+        {"seed", required_argument, NULL, 's'},
+        {"trace", required_argument, NULL, 't'},
+        {"left-gain", required_argument, NULL, 1},
+        {"right-gain", required_argument, NULL, 2},
+        {"kp", required_argument, NULL, 3},
+        {"ki-shift", required_argument, NULL, 4},
+        {"gyro-noise", required_argument, NULL, 5},
+        {"gyro-bias", required_argument, NULL, 6},
+        {"max-odometry-error", required_argument, NULL, 7},
+        {"max-fused-error", required_argument, NULL, 8},
+        {NULL, 0, NULL, 0}
+    };
+
+    Plant_Model_Config config;
+    double seconds = 5.0;
+    double left_gain = -1.0;
+    double max_odometry_error = -1.0;
+    double max_fused_error = -1.0;
+    const char *trace_name = NULL;
+    int option;
+
+    Plant_Model_Default_Config(&config);
+
+    while ((option = getopt_long(argc, argv, "d:T:s:t:", options, NULL)) != -1) {
+        switch (option) {
+            case 'd': Sim_Duty = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'T': seconds = strtod(optarg, NULL); break;
+            case 's': Sim_Random = strtoul(optarg, NULL, 0); break;
+            case 't': trace_name = optarg; break;
+            case 1: left_gain = strtod(optarg, NULL); break;
+            case 2: config.Right_Gain = strtod(optarg, NULL); break;
+            case 3: Sim_Kp = strtol(optarg, NULL, 0); break;
+            case 4: Sim_Ki_Shift = strtol(optarg, NULL, 0); break;
+            case 5: Sim_Gyro_Noise = strtod(optarg, NULL); break;
+            case 6: Sim_Gyro_Bias = strtod(optarg, NULL); break;
+            case 7: max_odometry_error = strtod(optarg, NULL); break;
+            case 8: max_fused_error = strtod(optarg, NULL); break;
+            default: Print_Usage(); return EXIT_FAILURE;
+        }
+    }
+
+    if ((optind + 1 != argc) || ((strcmp(argv[optind], "step") != 0) && (strcmp(argv[optind], "hold") != 0)) ||
+        (Sim_Duty >= TIMER_A0_PERIOD_CONSTANT) || (Sim_Ki_Shift < 0) || (Sim_Ki_Shift > 16)) {
+        Print_Usage();
+        return EXIT_FAILURE;
+    }
+
+    Sim_Hold = (strcmp(argv[optind], "hold") == 0);
+
+    // Without a gain given, the hold scenario uses a weaker left motor so that there is a drift to correct
+    config.Left_Gain = (left_gain >= 0.0) ? left_gain : (Sim_Hold ? 0.9 : 1.0);
+
+    if (Sim_Random == 0) {
+        Sim_Random = 0x9E3779B9;
+    }
+
+    FILE *trace = NULL;
+
+    if (trace_name != NULL) {
+        trace = fopen(trace_name, "w");
+
+        if (trace == NULL) {
+            perror(trace_name);
+            return EXIT_FAILURE;
+        }
+
+        fprintf(trace, "time_s,left_duty,right_duty,left_rpm,right_rpm,tach_left_rpm,tach_right_rpm,"
+                       "x_mm,y_mm,theta_deg,odometry_x_mm,odometry_y_mm,odometry_theta_deg,fused_theta_deg\n");
+    }
+
+    Clock_Init48MHz();
+    Motor_Init();
+    Tachometer_Init();
+    Odometry_Init();
+    Heading_Fusion_Init(SIM_CONTROL_RATE_HZ);
+    Timer_A1_Interrupt_Init(&Sim_Control_Task, SIM_CONTROL_TIMER_PERIOD);
+    Plant_Model_Init(&config);
+
+    uint32_t periods = (uint32_t)(seconds * SIM_CONTROL_RATE_HZ);
+    uint32_t stop_period = Sim_Hold ? periods : (periods * 4) / 5;
+    double rpm_per_rad_s = 60.0 / (2.0 * SIM_PI);
+
+    // Step response: time until the wheel speed first reaches 90% of its average before stopping
+    double rise_time = -1.0;
+    double final_rpm = 0.0;
+
+    // True wheel speeds averaged over the last SIM_AVERAGE_PERIODS before stopping (the 50 Hz PWM
+    // makes the speed ripple within each PWM period) and Tachometer speeds at the stop
+    double left_rpm = 0.0;
+    double right_rpm = 0.0;
+    int16_t tach_left = 0;
+    int16_t tach_right = 0;
+    double *speeds = malloc((size_t)(periods + 1) * sizeof(double));
+
+    // Heading hold: true heading error and fused heading error
+    double heading_sum = 0.0;
+    double heading_max = 0.0;
+    double fused_sum = 0.0;
+    uint32_t hold_samples = 0;
+
+    struct timespec start_time;
+    struct timespec end_time;
+
+    if (speeds == NULL) {
+        fprintf(stderr, "plant_sim: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    Sim_Driving = 1;
+    Sim_Target = 0;
+    Motor_Forward(Sim_Duty, Sim_Duty);
+
+    for (uint32_t period = 0; period < periods; period++) {
+        Plant_Model_State state;
+
+        if (period == stop_period) {
+            Sim_Driving = 0;
+            Motor_Stop();
+        }
+
+        // Send the yaw rate of the platform as the gyroscope Z rate every 50 ms
+        if ((period % SIM_GYRO_DIVIDER) == 0) {
+            Plant_Model_Get_State(&state);
+            Heading_Fusion_Set_Gyro_Rate((int32_t)lround(state.Angular_Velocity * 1000.0 + Sim_Gyro_Bias +
+                                                         Sim_Gyro_Noise * Sim_Noise()));
+        }
+
+        Plant_Model_Advance(SIM_CONTROL_CYCLES);
+        TA1_0_IRQHandler();
+
+        Plant_Model_State truth;
+        Odometry_Pose pose;
+        Heading_Fusion_State heading;
+
+        Plant_Model_Get_State(&truth);
+        Odometry_Get_Pose(&pose);
+        Heading_Fusion_Get(&heading);
+
+        speeds[period] = 0.5 * (truth.Left.Speed + truth.Right.Speed) * rpm_per_rad_s;
+
+        if ((period < stop_period) && (period + SIM_AVERAGE_PERIODS >= stop_period)) {
+            left_rpm += truth.Left.Speed * rpm_per_rad_s / SIM_AVERAGE_PERIODS;
+            right_rpm += truth.Right.Speed * rpm_per_rad_s / SIM_AVERAGE_PERIODS;
+        }
+
+        if (period + 1 == stop_period) {
+            Tachometer_Get_RPM(&tach_left, &tach_right);
+        }
+
+        if (Sim_Hold && (period >= SIM_CONTROL_RATE_HZ / 2)) {
+            double error = fabs(truth.Theta);
+            double fused_error = Sim_Binary_Angle_To_Radians(heading.Heading - (uint32_t)lround(truth.Theta * 4294967296.0 / (2.0 * SIM_PI)));
+
+            heading_sum += error * error;
+            heading_max = (error > heading_max) ? error : heading_max;
+            fused_sum += fused_error * fused_error;
+            hold_samples++;
+        }
+
+        if (trace != NULL) {
+            int16_t tach_left;
+            int16_t tach_right;
+
+            Tachometer_Get_RPM(&tach_left, &tach_right);
+
+            fprintf(trace, "%.3f,%u,%u,%.2f,%.2f,%d,%d,%.2f,%.2f,%.3f,%.2f,%.2f,%.3f,%.3f\n",
+                    (double)truth.Cycles / 48e6, TIMER_A0->CCR[4], TIMER_A0->CCR[3],
+                    truth.Left.Speed * rpm_per_rad_s, truth.Right.Speed * rpm_per_rad_s, tach_left, tach_right,
+                    truth.X * 1e3, truth.Y * 1e3, truth.Theta * 180.0 / SIM_PI,
+                    pose.X * 1e-3, pose.Y * 1e-3, Sim_Binary_Angle_To_Radians(pose.Theta) * 180.0 / SIM_PI,
+                    Sim_Binary_Angle_To_Radians(heading.Heading) * 180.0 / SIM_PI);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    if (trace != NULL) {
+        fclose(trace);
+    }
+
+    Plant_Model_State truth;
+    Odometry_Pose pose;
+
+    Plant_Model_Get_State(&truth);
+    Odometry_Get_Pose(&pose);
+
+    double host_seconds = (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) * 1e-9;
+    double simulated_seconds = (double)truth.Cycles / 48e6;
+    double position_error = hypot(pose.X * 1e-6 - truth.X, pose.Y * 1e-6 - truth.Y);
+    double heading_error = Sim_Binary_Angle_To_Radians(pose.Theta - (uint32_t)lround(truth.Theta * 4294967296.0 / (2.0 * SIM_PI)));
+    double fused_rms = hold_samples ? sqrt(fused_sum / hold_samples) * 180.0 / SIM_PI : 0.0;
+
+    if (!Sim_Hold && (stop_period > 0)) {
+        final_rpm = 0.5 * (left_rpm + right_rpm);
+
+        for (uint32_t i = 0; i < stop_period; i++) {
+            if (speeds[i] >= 0.9 * final_rpm) {
+                rise_time = (double)(i + 1) / SIM_CONTROL_RATE_HZ;
+                break;
+            }
+        }
+    }
+
+    printf("scenario:         %s, duty %u, left gain %.2f, right gain %.2f\n", argv[optind], Sim_Duty, config.Left_Gain, config.Right_Gain);
+    printf("distance:         %.1f mm (x %.1f mm, y %.1f mm, heading %.2f deg)\n",
+           1e3 * hypot(truth.X, truth.Y), truth.X * 1e3, truth.Y * 1e3, truth.Theta * 180.0 / SIM_PI);
+    printf("encoder steps:    left %d, right %d\n", truth.Left.Steps, truth.Right.Steps);
+
+    printf("speed:            left %.1f rpm (tachometer %d), right %.1f rpm (tachometer %d)\n",
+           left_rpm, tach_left, right_rpm, tach_right);
+
+    if (!Sim_Hold) {
+        printf("step response:    90%% of %.1f rpm reached after %.3f s\n", final_rpm, rise_time);
+    } else {
+        printf("heading error:    rms %.3f deg, max %.3f deg (after 0.5 s)\n",
+               hold_samples ? sqrt(heading_sum / hold_samples) * 180.0 / SIM_PI : 0.0, heading_max * 180.0 / SIM_PI);
+        printf("fused heading:    rms error %.3f deg\n", fused_rms);
+    }
+
+    printf("odometry error:   %.2f mm, %.3f deg\n", position_error * 1e3, heading_error * 180.0 / SIM_PI);
+    printf("simulated time:   %.3f s\n", simulated_seconds);
+    printf("host time:        %.3f s (%.0fx real time)\n", host_seconds, (host_seconds > 0.0) ? simulated_seconds / host_seconds : 0.0);
+
+    free(speeds);
+
+    int status = EXIT_SUCCESS;
+
+    if ((max_odometry_error >= 0.0) && !(position_error * 1e3 <= max_odometry_error)) {
+        printf("FAIL: odometry error %.2f mm, limit %.2f mm\n", position_error * 1e3, max_odometry_error);
+        status = EXIT_FAILURE;
+    }
+
+    if ((max_fused_error >= 0.0) && (!Sim_Hold || !(fused_rms <= max_fused_error))) {
+        printf("FAIL: fused heading rms error %.3f deg, limit %.3f deg\n", fused_rms, max_fused_error);
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}